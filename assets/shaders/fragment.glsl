@@ -6,8 +6,15 @@ struct Light
     vec3 direction;
 };
 
-uniform Light uLight;
-uniform vec3 uCameraPos;
+layout (std140) uniform FrameData
+{
+    mat4 uView;
+    mat4 uProjection;
+    vec3 uCameraPos;
+    float uTime;
+    Light uLight;
+};
+
 uniform vec3 color;
 
 out vec4 FragColor;
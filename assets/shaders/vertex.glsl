@@ -8,9 +8,27 @@ out vec2 vUV;
 out vec3 vNormal;
 out vec3 vFragPos;
 
+struct Light
+{
+    vec3 color;
+    vec3 direction;
+};
+
+layout (std140) uniform FrameData
+{
+    mat4 uView;
+    mat4 uProjection;
+    vec3 uCameraPos;
+    float uTime;
+    Light uLight;
+};
+
+#ifdef INSTANCED
+layout (location = 4) in mat4 instanceModel;
+#define uModel instanceModel
+#else
 uniform mat4 uModel;
-uniform mat4 uView;
-uniform mat4 uProjection;
+#endif
 
 void main()
 {
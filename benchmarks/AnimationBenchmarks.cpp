@@ -0,0 +1,57 @@
+#include "Benchmark.h"
+#include <eng.h>
+
+#include <memory>
+#include <string>
+
+static void UpdateClips(BenchmarkRun& run)
+{
+    // 50 characters with 64 bones, every bone has 120 keys per channel.
+    // AnimationComponent::Interpolate is private, it is measured through
+    // the update that calls it once per channel.
+    const size_t characters = 50;
+    const size_t bones = 64;
+    const size_t keys = 120;
+
+    auto clip = std::make_shared<eng::AnimationClip>();
+    clip->name = "Walk";
+    clip->duration = 4.0f;
+    for (size_t b = 0; b < bones; ++b)
+    {
+        eng::TransformTrack track;
+        track.targetName = "Bone" + std::to_string(b);
+        for (size_t k = 0; k < keys; ++k)
+        {
+            const float time = clip->duration * k / (keys - 1);
+            track.positions.push_back({ time, glm::vec3(time, static_cast<float>(b), 0.0f) });
+            track.rotations.push_back({ time, glm::angleAxis(time, glm::vec3(0.0f, 1.0f, 0.0f)) });
+        }
+        clip->tracks.push_back(track);
+    }
+
+    auto scene = std::make_shared<eng::Scene>();
+    for (size_t c = 0; c < characters; ++c)
+    {
+        auto root = scene->CreateObject("Character");
+        for (size_t b = 0; b < bones; ++b)
+        {
+            scene->CreateObject("Bone" + std::to_string(b), root);
+        }
+
+        auto animation = new eng::AnimationComponent();
+        root->AddComponent(animation);
+        animation->RegisterClip(clip->name, clip);
+        animation->Play(clip->name);
+    }
+
+    run.SetItems(characters * bones * 2);
+    run.Measure([&]()
+        {
+            scene->Update(1.0f / 60.0f);
+        });
+}
+
+void RegisterAnimationBenchmarks(BenchmarkRunner& runner)
+{
+    runner.Add("Animation/Update/50x64", UpdateClips);
+}
\ No newline at end of file
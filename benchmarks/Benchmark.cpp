@@ -0,0 +1,164 @@
+#include "Benchmark.h"
+#include <eng.h>
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+BenchmarkRun::BenchmarkRun(size_t samples) : m_sampleCount(samples)
+{
+}
+
+void BenchmarkRun::SetItems(size_t items)
+{
+    m_items = items > 0 ? items : 1;
+}
+
+size_t BenchmarkRun::GetItems() const
+{
+    return m_items;
+}
+
+void BenchmarkRun::SetCounter(const std::string& name, double value)
+{
+    m_counters[name] = value;
+}
+
+const std::map<std::string, double>& BenchmarkRun::GetCounters() const
+{
+    return m_counters;
+}
+
+const std::vector<double>& BenchmarkRun::GetSamples() const
+{
+    return m_samplesMs;
+}
+
+void BenchmarkRunner::Add(const std::string& name, const BenchmarkFunc& func)
+{
+    m_benchmarks.push_back({ name, func });
+}
+
+int BenchmarkRunner::Run(int argc, char** argv)
+{
+    std::string filter;
+    std::string outPath;
+    size_t samples = 10;
+    bool listOnly = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+        {
+            filter = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--samples") == 0 && i + 1 < argc)
+        {
+            samples = std::max<size_t>(std::strtoul(argv[++i], nullptr, 10), 1);
+        }
+        else if (std::strcmp(argv[i], "--out") == 0 && i + 1 < argc)
+        {
+            outPath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--list") == 0)
+        {
+            listOnly = true;
+        }
+        else
+        {
+            std::cerr << "Unknown option " << argv[i] << std::endl;
+            return 1;
+        }
+    }
+
+    nlohmann::json results = nlohmann::json::array();
+    std::cout << std::left << std::setw(44) << "benchmark" << std::right
+        << std::setw(12) << "median ms"
+        << std::setw(12) << "min ms"
+        << std::setw(12) << "max ms"
+        << std::setw(14) << "ns/item" << "\n";
+    std::cout << std::fixed << std::setprecision(3);
+
+    for (auto& benchmark : m_benchmarks)
+    {
+        if (!filter.empty() && benchmark.name.find(filter) == std::string::npos)
+        {
+            continue;
+        }
+        if (listOnly)
+        {
+            std::cout << benchmark.name << "\n";
+            continue;
+        }
+
+        BenchmarkRun run(samples);
+        benchmark.func(run);
+
+        auto values = run.GetSamples();
+        if (values.empty())
+        {
+            continue;
+        }
+        std::sort(values.begin(), values.end());
+        double total = 0.0;
+        for (auto value : values)
+        {
+            total += value;
+        }
+
+        const double median = values[values.size() / 2];
+        const double mean = total / values.size();
+        const double nsPerItem = median * 1e6 / run.GetItems();
+
+        nlohmann::json result;
+        result["name"] = benchmark.name;
+        result["samples"] = values.size();
+        result["items"] = run.GetItems();
+        result["min_ms"] = values.front();
+        result["median_ms"] = median;
+        result["mean_ms"] = mean;
+        result["max_ms"] = values.back();
+        result["ns_per_item"] = nsPerItem;
+        for (auto& counter : run.GetCounters())
+        {
+            result["counters"][counter.first] = counter.second;
+        }
+        results.push_back(result);
+
+        std::cout << std::left << std::setw(44) << benchmark.name << std::right
+            << std::setw(12) << median
+            << std::setw(12) << values.front()
+            << std::setw(12) << values.back()
+            << std::setw(14) << nsPerItem << std::endl;
+    }
+
+    if (listOnly || outPath.empty())
+    {
+        return 0;
+    }
+
+    nlohmann::json report;
+    report["version"] = 1;
+#ifdef NDEBUG
+    report["build"] = "release";
+#else
+    report["build"] = "debug";
+#endif
+    report["threads"] = eng::Engine::GetInstance().GetJobSystem().GetThreadCount();
+    report["hardware_threads"] = std::thread::hardware_concurrency();
+    report["benchmarks"] = results;
+
+    std::ofstream out(outPath);
+    if (!out)
+    {
+        std::cerr << "Cannot write " << outPath << std::endl;
+        return 1;
+    }
+    out << report.dump(2);
+    return 0;
+}
\ No newline at end of file
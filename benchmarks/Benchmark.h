@@ -0,0 +1,81 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+// One benchmark execution. Measure times the body once per sample, the
+// setup runs before every sample and is not timed.
+class BenchmarkRun
+{
+public:
+    explicit BenchmarkRun(size_t samples);
+
+    template<typename Body>
+    void Measure(Body&& body)
+    {
+        Measure([]() {}, body);
+    }
+
+    template<typename Setup, typename Body>
+    void Measure(Setup&& setup, Body&& body)
+    {
+        // The first run warms caches and pools and is not recorded
+        setup();
+        body();
+
+        m_samplesMs.clear();
+        for (size_t i = 0; i < m_sampleCount; ++i)
+        {
+            setup();
+            auto start = std::chrono::steady_clock::now();
+            body();
+            auto end = std::chrono::steady_clock::now();
+            m_samplesMs.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+        }
+    }
+
+    // Work items per sample, used for the time per item
+    void SetItems(size_t items);
+    size_t GetItems() const;
+    // Extra value reported with the result, like draw calls or allocations
+    void SetCounter(const std::string& name, double value);
+    const std::map<std::string, double>& GetCounters() const;
+    const std::vector<double>& GetSamples() const;
+
+private:
+    size_t m_sampleCount = 0;
+    size_t m_items = 1;
+    std::vector<double> m_samplesMs;
+    std::map<std::string, double> m_counters;
+};
+
+using BenchmarkFunc = std::function<void(BenchmarkRun&)>;
+
+// Runs the registered benchmarks and writes the results as JSON, so runs of
+// different versions can be compared by a script
+class BenchmarkRunner
+{
+public:
+    void Add(const std::string& name, const BenchmarkFunc& func);
+    // Options: --filter <text>, --samples <n>, --out <file.json>, --list
+    int Run(int argc, char** argv);
+
+private:
+    struct Entry
+    {
+        std::string name;
+        BenchmarkFunc func;
+    };
+
+    std::vector<Entry> m_benchmarks;
+};
+
+void RegisterSceneBenchmarks(BenchmarkRunner& runner);
+void RegisterRenderBenchmarks(BenchmarkRunner& runner);
+void RegisterResourceBenchmarks(BenchmarkRunner& runner);
+void RegisterAnimationBenchmarks(BenchmarkRunner& runner);
+void RegisterPhysicsBenchmarks(BenchmarkRunner& runner);
+void RegisterFrameBenchmarks(BenchmarkRunner& runner);
\ No newline at end of file
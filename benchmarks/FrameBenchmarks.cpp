@@ -0,0 +1,83 @@
+#include "Benchmark.h"
+#include <eng.h>
+
+#include <memory>
+
+static std::shared_ptr<eng::Scene> CreateFrameScene(size_t meshCount)
+{
+    auto scene = std::make_shared<eng::Scene>();
+    auto camera = scene->CreateObject("Camera");
+    camera->AddComponent(new eng::CameraComponent());
+    camera->SetPosition(glm::vec3(50.0f, 20.0f, -30.0f));
+    scene->SetMainCamera(camera);
+
+    auto light = scene->CreateObject("Light");
+    light->AddComponent(new eng::LightComponent());
+    light->SetPosition(glm::vec3(0.0f, 50.0f, 0.0f));
+
+    auto material = eng::Material::Load("materials/brick.mat");
+    auto mesh = eng::Mesh::CreateBox();
+    for (size_t i = 0; i < meshCount; ++i)
+    {
+        auto object = scene->CreateObject("Mesh");
+        object->SetPosition(glm::vec3(static_cast<float>(i % 100), 0.0f, static_cast<float>(i / 100)));
+        object->AddComponent(new eng::MeshComponent(material, mesh));
+    }
+    return scene;
+}
+
+static void RunFrames(BenchmarkRun& run, bool pipelined, float fixedTimestep)
+{
+    // Whole engine frames on the null backend, the samples are runs of
+    // frameCount frames and the frame time percentiles come from the last
+    const size_t frameCount = 120;
+    auto& engine = eng::Engine::GetInstance();
+    engine.SetScene(CreateFrameScene(5000));
+    engine.SetPipelined(pipelined);
+    engine.SetFixedTimestep(fixedTimestep);
+
+    eng::FrameTimeReport report;
+    const eng::AllocationStats before = eng::ObjectPools::GetTotalStats();
+    size_t frames = 0;
+    run.SetItems(frameCount);
+    run.Measure([&]()
+        {
+            report = engine.Run(frameCount, 1.0f / 60.0f);
+            frames += frameCount;
+        });
+    const eng::AllocationStats after = eng::ObjectPools::GetTotalStats();
+
+    run.SetCounter("frame_p50_ms", report.p50Ms);
+    run.SetCounter("frame_p90_ms", report.p90Ms);
+    run.SetCounter("frame_p99_ms", report.p99Ms);
+    run.SetCounter("frame_heap_allocations", static_cast<double>(engine.GetFrameAllocator().GetLastFrameHeapAllocations()));
+    // Pooled objects and components per frame over all the samples
+    run.SetCounter("pool_allocations", static_cast<double>(after.allocations - before.allocations) / frames);
+    run.SetCounter("pool_heap_allocations", static_cast<double>(after.heapAllocations - before.heapAllocations) / frames);
+
+    engine.SetPipelined(false);
+    engine.SetFixedTimestep(0.0f);
+    engine.SetScene(nullptr);
+}
+
+static void Serial(BenchmarkRun& run)
+{
+    RunFrames(run, false, 0.0f);
+}
+
+static void Pipelined(BenchmarkRun& run)
+{
+    RunFrames(run, true, 0.0f);
+}
+
+static void FixedTimestep(BenchmarkRun& run)
+{
+    RunFrames(run, false, 1.0f / 120.0f);
+}
+
+void RegisterFrameBenchmarks(BenchmarkRunner& runner)
+{
+    runner.Add("Engine/Frame/Serial/5000", Serial);
+    runner.Add("Engine/Frame/Pipelined/5000", Pipelined);
+    runner.Add("Engine/Frame/FixedTimestep/5000", FixedTimestep);
+}
\ No newline at end of file
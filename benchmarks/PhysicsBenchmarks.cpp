@@ -0,0 +1,61 @@
+#include "Benchmark.h"
+#include <eng.h>
+
+#include <memory>
+#include <vector>
+
+static void StepBodies(BenchmarkRun& run, size_t count)
+{
+    // Spheres dropped in a grid onto a static floor, one second per sample
+    const size_t steps = 60;
+    auto& physics = eng::Engine::GetInstance().GetPhysicsManager();
+    std::vector<std::shared_ptr<eng::RigidBody>> bodies;
+    auto sphere = std::make_shared<eng::SphereCollider>(0.5f);
+    auto floorCollider = std::make_shared<eng::BoxCollider>(glm::vec3(500.0f, 1.0f, 500.0f));
+
+    run.SetItems(count * steps);
+    run.Measure([&]()
+        {
+            bodies.clear();
+            auto floor = std::make_shared<eng::RigidBody>(eng::BodyType::Static, floorCollider, 0.0f, 0.5f);
+            floor->SetPosition(glm::vec3(0.0f, -1.0f, 0.0f));
+            physics.AddRigidBody(floor.get());
+            bodies.push_back(floor);
+
+            const size_t side = 32;
+            for (size_t i = 0; i < count; ++i)
+            {
+                auto body = std::make_shared<eng::RigidBody>(eng::BodyType::Dynamic, sphere, 1.0f, 0.5f);
+                body->SetPosition(glm::vec3(
+                    static_cast<float>(i % side) * 1.5f,
+                    2.0f + static_cast<float>(i / (side * side)) * 1.5f,
+                    static_cast<float>((i / side) % side) * 1.5f));
+                physics.AddRigidBody(body.get());
+                bodies.push_back(body);
+            }
+        },
+        [&]()
+        {
+            for (size_t i = 0; i < steps; ++i)
+            {
+                physics.Step(1.0f / 60.0f);
+            }
+        });
+    bodies.clear();
+}
+
+static void Step1000(BenchmarkRun& run)
+{
+    StepBodies(run, 1000);
+}
+
+static void Step5000(BenchmarkRun& run)
+{
+    StepBodies(run, 5000);
+}
+
+void RegisterPhysicsBenchmarks(BenchmarkRunner& runner)
+{
+    runner.Add("Physics/Step60/1000", Step1000);
+    runner.Add("Physics/Step60/5000", Step5000);
+}
\ No newline at end of file
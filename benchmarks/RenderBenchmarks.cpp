@@ -0,0 +1,155 @@
+#include "Benchmark.h"
+#include <eng.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <memory>
+#include <random>
+#include <vector>
+
+// A mix of materials and meshes in random order and at random positions,
+// as a scene produces it
+struct RenderScene
+{
+    std::vector<std::shared_ptr<eng::Material>> materials;
+    std::vector<std::shared_ptr<eng::Mesh>> meshes;
+    std::vector<eng::RenderCommand> commands;
+
+    explicit RenderScene(size_t count)
+    {
+        for (size_t i = 0; i < 8; ++i)
+        {
+            materials.push_back(eng::Material::Load(i % 2 == 0 ? "materials/brick.mat" : "materials/checker.mat"));
+        }
+        meshes.push_back(eng::Mesh::CreateBox());
+        meshes.push_back(eng::Mesh::CreateSphere(1.0f, 16, 16));
+        meshes.push_back(eng::Mesh::CreatePlane());
+
+        commands.resize(count);
+        std::mt19937 random(1234);
+        std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+        for (auto& command : commands)
+        {
+            command.material = materials[random() % materials.size()].get();
+            command.mesh = meshes[random() % meshes.size()].get();
+            command.modelMatrix = glm::translate(glm::mat4(1.0f),
+                glm::vec3(position(random), position(random), position(random)));
+        }
+    }
+
+    void Submit()
+    {
+        auto& renderQueue = eng::Engine::GetInstance().GetRenderQueue();
+        for (auto& command : commands)
+        {
+            renderQueue.Submit(command);
+        }
+        // Looking down -z from the middle of the objects, so about half of
+        // them are behind the camera
+        eng::CameraData cameraData;
+        cameraData.viewMatrix = glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        cameraData.projectionMatrix = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 500.0f);
+        renderQueue.EndFrame(cameraData, eng::FrameVector<eng::LightData>());
+        renderQueue.SwapFrames();
+    }
+};
+
+static void SetStateCounters(BenchmarkRun& run)
+{
+    // Per frame, the warm up run included
+    const auto& stats = eng::NullGraphicsBackend::GetStats();
+    const double frames = static_cast<double>(run.GetSamples().size() + 1);
+    run.SetCounter("draw_calls", stats.drawCalls / frames);
+    run.SetCounter("instances_drawn", stats.instancesDrawn / frames);
+    run.SetCounter("program_binds", stats.programBinds / frames);
+    run.SetCounter("texture_binds", stats.textureBinds / frames);
+    run.SetCounter("uniform_uploads", stats.uniformUploads / frames);
+
+    const auto& queueStats = eng::Engine::GetInstance().GetRenderQueue().GetStats();
+    run.SetCounter("visible", static_cast<double>(queueStats.visibleCommands));
+    run.SetCounter("culled", static_cast<double>(queueStats.culledCommands));
+    run.SetCounter("instanced_draws", static_cast<double>(queueStats.instancedDraws));
+    run.SetCounter("program_changes", static_cast<double>(queueStats.programChanges));
+    run.SetCounter("material_changes", static_cast<double>(queueStats.materialChanges));
+    run.SetCounter("mesh_changes", static_cast<double>(queueStats.meshChanges));
+}
+
+static void SubmitAndDraw(BenchmarkRun& run)
+{
+    RenderScene scene(10000);
+    auto& engine = eng::Engine::GetInstance();
+    eng::NullGraphicsBackend::ResetStats();
+    run.SetItems(scene.commands.size());
+    run.Measure([&]()
+        {
+            scene.Submit();
+            engine.GetRenderQueue().Draw(engine.GetGraphicsAPI());
+        });
+    SetStateCounters(run);
+}
+
+static void Draw(BenchmarkRun& run)
+{
+    RenderScene scene(10000);
+    auto& engine = eng::Engine::GetInstance();
+    eng::NullGraphicsBackend::ResetStats();
+    run.SetItems(scene.commands.size());
+    run.Measure([&]()
+        {
+            scene.Submit();
+        },
+        [&]()
+        {
+            engine.GetRenderQueue().Draw(engine.GetGraphicsAPI());
+        });
+    SetStateCounters(run);
+}
+
+static void Draw2D(BenchmarkRun& run)
+{
+    // Sprites set nine uniforms each
+    const size_t count = 10000;
+    auto texture = eng::Texture::Load("textures/brick.png");
+    std::vector<eng::RenderCommand2D> commands(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto& command = commands[i];
+        command.modelMatrix = glm::translate(glm::mat4(1.0f), glm::vec3(static_cast<float>(i % 100), static_cast<float>(i / 100), 0.0f));
+        command.texture = texture.get();
+        command.color = glm::vec4(1.0f);
+        command.size = glm::vec2(1.0f);
+        command.lowerLeftUV = glm::vec2(0.0f);
+        command.upperRightUV = glm::vec2(1.0f);
+        command.pivot = glm::vec2(0.5f);
+    }
+
+    auto& engine = eng::Engine::GetInstance();
+    auto& renderQueue = engine.GetRenderQueue();
+    eng::NullGraphicsBackend::ResetStats();
+    run.SetItems(count);
+    run.Measure([&]()
+        {
+            for (auto& command : commands)
+            {
+                renderQueue.Submit(command);
+            }
+            renderQueue.EndFrame(eng::CameraData(), eng::FrameVector<eng::LightData>());
+            renderQueue.SwapFrames();
+        },
+        [&]()
+        {
+            renderQueue.Draw(engine.GetGraphicsAPI());
+        });
+
+    const auto& stats = eng::NullGraphicsBackend::GetStats();
+    const double frames = static_cast<double>(run.GetSamples().size() + 1);
+    run.SetCounter("draw_calls", stats.drawCalls / frames);
+    run.SetCounter("uniform_uploads", stats.uniformUploads / frames);
+}
+
+void RegisterRenderBenchmarks(BenchmarkRunner& runner)
+{
+    runner.Add("RenderQueue/SubmitDraw/10000", SubmitAndDraw);
+    runner.Add("RenderQueue/Draw/10000", Draw);
+    runner.Add("RenderQueue/Draw2D/10000", Draw2D);
+}
\ No newline at end of file
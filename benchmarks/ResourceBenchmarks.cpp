@@ -0,0 +1,74 @@
+#include "Benchmark.h"
+#include <eng.h>
+
+#include <memory>
+
+static void LoadGLTF(BenchmarkRun& run, const std::string& path)
+{
+    std::shared_ptr<eng::Scene> scene;
+    run.Measure([&]()
+        {
+            scene = std::make_shared<eng::Scene>();
+        },
+        [&]()
+        {
+            eng::GameObject::LoadGLTF(path, scene.get());
+        });
+}
+
+static void LoadSuzanne(BenchmarkRun& run)
+{
+    LoadGLTF(run, "models/suzanne/Suzanne.gltf");
+}
+
+static void LoadCarbine(BenchmarkRun& run)
+{
+    LoadGLTF(run, "models/sten_gunmachine_carbine/scene.gltf");
+}
+
+static void GetFontCold(BenchmarkRun& run)
+{
+    // A new manager every sample, so the glyph atlas is built each time
+    std::unique_ptr<eng::FontManager> fonts;
+    run.Measure([&]()
+        {
+            fonts = std::make_unique<eng::FontManager>();
+            fonts->Init();
+        },
+        [&]()
+        {
+            fonts->GetFont("fonts/arial.ttf", 32);
+        });
+}
+
+static void GetFontCached(BenchmarkRun& run)
+{
+    const size_t count = 10000;
+    auto& fonts = eng::Engine::GetInstance().GetFontManager();
+    fonts.GetFont("fonts/arial.ttf", 32);
+    run.SetItems(count);
+    run.Measure([&]()
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                fonts.GetFont("fonts/arial.ttf", 32);
+            }
+        });
+}
+
+static void LoadMaterial(BenchmarkRun& run)
+{
+    run.Measure([&]()
+        {
+            eng::Material::Load("materials/brick.mat");
+        });
+}
+
+void RegisterResourceBenchmarks(BenchmarkRunner& runner)
+{
+    runner.Add("GLTF/Load/Suzanne", LoadSuzanne);
+    runner.Add("GLTF/Load/StenCarbine", LoadCarbine);
+    runner.Add("FontManager/GetFont/Cold", GetFontCold);
+    runner.Add("FontManager/GetFont/Cached", GetFontCached);
+    runner.Add("Material/Load", LoadMaterial);
+}
\ No newline at end of file
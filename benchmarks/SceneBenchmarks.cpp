@@ -0,0 +1,246 @@
+#include "Benchmark.h"
+#include <eng.h>
+
+#include <nlohmann/json.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <random>
+
+static void CreateRoots(BenchmarkRun& run)
+{
+    const size_t count = 50000;
+    std::shared_ptr<eng::Scene> scene;
+    run.SetItems(count);
+    run.Measure([&]()
+        {
+            scene = std::make_shared<eng::Scene>();
+        },
+        [&]()
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                scene->CreateObject("Object");
+            }
+        });
+}
+
+static void Reparent(BenchmarkRun& run)
+{
+    const size_t count = 10000;
+    auto scene = std::make_shared<eng::Scene>();
+    auto first = scene->CreateObject("First");
+    auto second = scene->CreateObject("Second");
+    std::vector<eng::GameObject*> objects;
+    for (size_t i = 0; i < count; ++i)
+    {
+        objects.push_back(scene->CreateObject("Object", first));
+    }
+
+    // Every object moves to the other parent and back
+    run.SetItems(count * 2);
+    run.Measure([&]()
+        {
+            for (auto object : objects)
+            {
+                object->SetParent(second);
+            }
+            for (auto object : objects)
+            {
+                object->SetParent(first);
+            }
+        });
+}
+
+static void PropagateTransforms(BenchmarkRun& run)
+{
+    // Random tree with a fixed seed, every node moves every frame
+    const uint32_t count = 100000;
+    eng::TransformStore store;
+    std::vector<uint32_t> ids;
+    std::mt19937 random(1234);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        const uint32_t id = store.Create();
+        if (!ids.empty())
+        {
+            store.SetParent(id, ids[random() % ids.size()]);
+        }
+        ids.push_back(id);
+    }
+    store.UpdateWorldTransforms();
+
+    float offset = 0.0f;
+    run.SetItems(count);
+    run.Measure([&]()
+        {
+            offset += 0.01f;
+            for (auto id : ids)
+            {
+                store.SetPosition(id, glm::vec3(offset, 0.0f, 0.0f));
+                store.MarkDirty(id);
+            }
+            store.UpdateWorldTransforms();
+        });
+}
+
+// Objects with a light and a listener. The components of each object are
+// also kept in the order they were added, for the baseline scan.
+static std::shared_ptr<eng::Scene> CreateComponentObjects(size_t count, std::vector<eng::GameObject*>& objects,
+    std::vector<std::vector<eng::Component*>>& components)
+{
+    auto scene = std::make_shared<eng::Scene>();
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto object = scene->CreateObject("Object");
+        auto light = new eng::LightComponent();
+        auto listener = new eng::AudioListenerComponent();
+        object->AddComponent(light);
+        object->AddComponent(listener);
+        objects.push_back(object);
+        components.push_back({ light, listener });
+    }
+    return scene;
+}
+
+// The lookup before the slot table, a scan of the components that asks the
+// factory about the parents of every type it passes
+template<typename T>
+static T* FindComponentByScan(const std::vector<eng::Component*>& components)
+{
+    const size_t typeId = eng::Component::StaticTypeId<T>();
+    auto& factory = eng::ComponentFactory::GetInstance();
+    for (auto component : components)
+    {
+        if (component->GetTypeId() == typeId || factory.HasParent(component->GetTypeId(), typeId))
+        {
+            return static_cast<T*>(component);
+        }
+    }
+    return nullptr;
+}
+
+static void GetComponent(BenchmarkRun& run)
+{
+    const size_t count = 10000;
+    std::vector<eng::GameObject*> objects;
+    std::vector<std::vector<eng::Component*>> components;
+    auto scene = CreateComponentObjects(count, objects, components);
+
+    // One hit and one miss per object
+    size_t found = 0;
+    run.SetItems(count * 2);
+    run.Measure([&]()
+        {
+            for (auto object : objects)
+            {
+                found += object->GetComponent<eng::LightComponent>() != nullptr;
+                found += object->GetComponent<eng::MeshComponent>() != nullptr;
+            }
+        });
+    run.SetCounter("found", static_cast<double>(found));
+}
+
+static void GetComponentByScan(BenchmarkRun& run)
+{
+    const size_t count = 10000;
+    std::vector<eng::GameObject*> objects;
+    std::vector<std::vector<eng::Component*>> components;
+    auto scene = CreateComponentObjects(count, objects, components);
+
+    // Same lookups as GetComponent
+    size_t found = 0;
+    run.SetItems(count * 2);
+    run.Measure([&]()
+        {
+            for (auto& objectComponents : components)
+            {
+                found += FindComponentByScan<eng::LightComponent>(objectComponents) != nullptr;
+                found += FindComponentByScan<eng::MeshComponent>(objectComponents) != nullptr;
+            }
+        });
+    run.SetCounter("found", static_cast<double>(found));
+}
+
+static void UpdateMeshes(BenchmarkRun& run)
+{
+    const size_t count = 5000;
+    auto scene = std::make_shared<eng::Scene>();
+    auto material = eng::Material::Load("materials/brick.mat");
+    auto mesh = eng::Mesh::CreateBox();
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto object = scene->CreateObject("Mesh");
+        object->SetPosition(glm::vec3(static_cast<float>(i % 100), 0.0f, static_cast<float>(i / 100)));
+        object->AddComponent(new eng::MeshComponent(material, mesh));
+    }
+
+    auto& renderQueue = eng::Engine::GetInstance().GetRenderQueue();
+    run.SetItems(count);
+    run.Measure([&]()
+        {
+            scene->Update(1.0f / 60.0f);
+            scene->LateUpdate(1.0f / 60.0f);
+            renderQueue.EndFrame(eng::CameraData(), eng::FrameVector<eng::LightData>());
+        });
+}
+
+static std::string WriteSceneFile(size_t count)
+{
+    // Roots with a few children each, the shape of a typical level
+    nlohmann::json objects = nlohmann::json::array();
+    for (size_t i = 0; i < count / 5; ++i)
+    {
+        nlohmann::json root;
+        root["name"] = "Root" + std::to_string(i);
+        root["position"] = { { "x", static_cast<float>(i % 200) }, { "y", 0.0f }, { "z", static_cast<float>(i / 200) } };
+        root["children"] = nlohmann::json::array();
+        for (size_t j = 0; j < 4; ++j)
+        {
+            nlohmann::json child;
+            child["name"] = "Child" + std::to_string(j);
+            child["position"] = { { "x", 0.0f }, { "y", static_cast<float>(j) }, { "z", 0.0f } };
+            child["components"] = nlohmann::json::array({ { { "type", "LightComponent" } } });
+            root["children"].push_back(child);
+        }
+        objects.push_back(root);
+    }
+
+    nlohmann::json scene;
+    scene["name"] = "BenchmarkScene";
+    scene["objects"] = objects;
+
+    const auto path = std::filesystem::temp_directory_path() / "eng_benchmark_scene.sc";
+    std::ofstream out(path);
+    out << scene.dump();
+    return path.string();
+}
+
+static void LoadScene(BenchmarkRun& run)
+{
+    const size_t count = 50000;
+    const std::string path = WriteSceneFile(count);
+    std::shared_ptr<eng::Scene> scene;
+    run.SetItems(count);
+    run.Measure([&]()
+        {
+            scene.reset();
+        },
+        [&]()
+        {
+            scene = eng::Scene::Load(path);
+        });
+    std::filesystem::remove(path);
+}
+
+void RegisterSceneBenchmarks(BenchmarkRunner& runner)
+{
+    runner.Add("Scene/CreateRoots/50000", CreateRoots);
+    runner.Add("Scene/Reparent/10000", Reparent);
+    runner.Add("Scene/LoadJson/50000", LoadScene);
+    runner.Add("Scene/UpdateMeshes/5000", UpdateMeshes);
+    runner.Add("Transform/Propagate/100000", PropagateTransforms);
+    runner.Add("GameObject/GetComponent/10000", GetComponent);
+    runner.Add("GameObject/GetComponentByScan/10000", GetComponentByScan);
+}
\ No newline at end of file
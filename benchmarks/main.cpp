@@ -0,0 +1,48 @@
+#include "Benchmark.h"
+#include <eng.h>
+
+// Nothing to do per frame, the benchmarks drive the engine themselves
+class BenchmarkApp : public eng::Application
+{
+public:
+    bool Init() override;
+    void Update(float deltaTime) override;
+    void Destroy() override;
+};
+
+bool BenchmarkApp::Init()
+{
+    return true;
+}
+
+void BenchmarkApp::Update(float deltaTime)
+{
+}
+
+void BenchmarkApp::Destroy()
+{
+}
+
+int main(int argc, char** argv)
+{
+    // Headless, so the benchmarks run the same on machines without a GPU
+    eng::Engine& engine = eng::Engine::GetInstance();
+    engine.SetApplication(new BenchmarkApp());
+    if (!engine.Init(1280, 720, true))
+    {
+        engine.Destroy();
+        return 1;
+    }
+
+    BenchmarkRunner runner;
+    RegisterSceneBenchmarks(runner);
+    RegisterRenderBenchmarks(runner);
+    RegisterResourceBenchmarks(runner);
+    RegisterAnimationBenchmarks(runner);
+    RegisterPhysicsBenchmarks(runner);
+    RegisterFrameBenchmarks(runner);
+    const int result = runner.Run(argc, argv);
+
+    engine.Destroy();
+    return result;
+}
\ No newline at end of file
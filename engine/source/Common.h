@@ -9,10 +9,10 @@ namespace eng
 
     struct CameraData
     {
-        glm::mat4 viewMatrix;
-        glm::mat4 projectionMatrix;
-        glm::mat4 orthoMatrix;
-        glm::vec3 position;
+        glm::mat4 viewMatrix = glm::mat4(1.0f);
+        glm::mat4 projectionMatrix = glm::mat4(1.0f);
+        glm::mat4 orthoMatrix = glm::mat4(1.0f);
+        glm::vec3 position = glm::vec3(0.0f);
     };
 
     struct LightData
@@ -3,9 +3,14 @@
 #include "scene/GameObject.h"
 #include "scene/Component.h"
 #include "scene/components/CameraComponent.h"
+#include "memory/PoolAllocator.h"
+#include "profiling/Profiler.h"
+#include "graphics/NullGraphicsBackend.h"
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include <iostream>
+#include <cmath>
+#include <algorithm>
 
 namespace eng
 {
@@ -60,16 +65,45 @@ namespace eng
         return instance;
     }
 
-    bool Engine::Init(int width, int height)
+    bool Engine::Init(int width, int height, bool headless)
     {
         if (!m_application)
         {
             return false;
         }
 
+        m_mainThreadId = std::this_thread::get_id();
+        m_headless = headless;
         Scene::RegisterTypes();
         m_application->RegisterTypes();
 
+        if (m_headless)
+        {
+            NullGraphicsBackend::Install();
+        }
+        else if (!InitWindow(width, height))
+        {
+            return false;
+        }
+
+        // The main thread takes part in every batch, so one core is left for it
+        const size_t cores = std::thread::hardware_concurrency();
+        m_jobSystem.Init(cores > 1 ? cores - 1 : 0);
+        m_frameAllocator.Init();
+        m_costAccounting.Init(m_jobSystem.GetThreadCount());
+
+        m_graphicsAPI.Init();
+        m_graphicsAPI.SetViewport(0, 0, width, height);
+        m_physicsManager.Init();
+        m_audioManager.Init(m_headless);
+        m_rederQueue.Init();
+        m_fontManager.Init();
+
+        return m_application->Init();
+    }
+
+    bool Engine::InitWindow(int width, int height)
+    {
         if (!glfwInit())
         {
             return false;
@@ -103,13 +137,12 @@ namespace eng
             return false;
         }
 
-        m_graphicsAPI.Init();
-        m_graphicsAPI.SetViewport(0, 0, width, height);
-        m_physicsManager.Init();
-        m_audioManager.Init();
-        m_rederQueue.Init();
-        m_fontManager.Init();
-        return m_application->Init();
+        return true;
+    }
+
+    bool Engine::IsHeadless() const
+    {
+        return m_headless;
     }
 
     void Engine::Run()
@@ -119,81 +152,337 @@ namespace eng
             return;
         }
 
-        m_lastTimePoint = std::chrono::high_resolution_clock::now();
-        while (!glfwWindowShouldClose(m_window) && !m_application->NeedsToBeClosed())
+        m_lastTimePoint = std::chrono::steady_clock::now();
+        while ((!m_window || !glfwWindowShouldClose(m_window)) && !m_application->NeedsToBeClosed())
         {
-            glfwPollEvents();
-
-            auto now = std::chrono::high_resolution_clock::now();
+            auto now = std::chrono::steady_clock::now();
             float deltaTime = std::chrono::duration<float>(now - m_lastTimePoint).count();
             m_lastTimePoint = now;
 
-            m_physicsManager.Update(deltaTime);
+            RunFrame(deltaTime);
+        }
+
+        m_application.reset(nullptr);
+    }
 
-            if (m_uiInputSystem.IsActive())
+    FrameTimeReport Engine::Run(size_t frameCount, float deltaTime)
+    {
+        std::vector<double> frameTimes;
+        if (!m_application)
+        {
+            return BuildFrameTimeReport(frameTimes);
+        }
+
+        frameTimes.reserve(frameCount);
+        for (size_t i = 0; i < frameCount; ++i)
+        {
+            if ((m_window && glfwWindowShouldClose(m_window)) || m_application->NeedsToBeClosed())
             {
-                m_uiInputSystem.Update(deltaTime);
+                break;
             }
 
-            m_application->Update(deltaTime);
+            auto start = std::chrono::steady_clock::now();
+            RunFrame(deltaTime);
+            auto end = std::chrono::steady_clock::now();
+            frameTimes.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+        }
 
-            m_graphicsAPI.ClearBuffers();
+        return BuildFrameTimeReport(frameTimes);
+    }
 
-            CameraData cameraData;
-            std::vector<LightData> lights;
+    void Engine::RunFrame(float deltaTime)
+    {
+        ENG_PROFILE_SCOPE("Engine::Frame");
+        const uint64_t frameStart = Profiler::Now();
+        if (m_window)
+        {
+            glfwPollEvents();
+        }
+        m_syntheticInput.Apply(m_inputManager, m_frameIndex);
 
-            int width = 0;
-            int height = 0;
-            glfwGetWindowSize(m_window, &width, &height);
-            float aspect = static_cast<float>(width) / static_cast<float>(height);
+        if (m_pipelined)
+        {
+            // The frame built by the previous update is drawn here while
+            // the next one is simulated on a worker
+            m_rederQueue.SwapFrames();
+            m_inPipelinedUpdate = true;
+            JobCounter counter = 0;
+            m_jobSystem.Submit([this, deltaTime]()
+                {
+                    UpdateFrame(deltaTime);
+                }, counter);
+            DrawFrame();
+            {
+                ENG_PROFILE_SCOPE("Engine::WaitForUpdate");
+                StageTimer timer(m_frameStats, FrameStage::WaitForUpdate);
+                m_jobSystem.Wait(counter);
+            }
+            m_inPipelinedUpdate = false;
 
+            if (m_pipelinedRequest != ToggleRequest::None)
+            {
+                SetPipelined(m_pipelinedRequest == ToggleRequest::Enable);
+                m_pipelinedRequest = ToggleRequest::None;
+            }
             if (m_currentScene)
             {
-                if (auto cameraObject = m_currentScene->GetMainCamera())
+                m_currentScene->ReleaseDestroyedObjects();
+            }
+            if (m_sceneRequested)
+            {
+                m_sceneRequested = false;
+                SetScene(m_requestedScene);
+                m_requestedScene = nullptr;
+            }
+        }
+        else
+        {
+            UpdateFrame(deltaTime);
+            m_rederQueue.SwapFrames();
+            DrawFrame();
+        }
+
+        // Requests from the workers of a parallel or pipelined update
+        const ToggleRequest cursorRequest = m_cursorRequest.exchange(ToggleRequest::None);
+        if (cursorRequest != ToggleRequest::None)
+        {
+            SetCursorEnabled(cursorRequest == ToggleRequest::Enable);
+        }
+        m_graphicsAPI.ReleaseDeferredDeletes();
+
+        m_costAccounting.EndFrame();
+        m_frameAllocator.EndFrame();
+        ObjectPools::EndFrame();
+        m_frameStats.SetAllocationStats(ObjectPools::GetFrameStats(), ObjectPools::GetTotalStats());
+        m_frameStats.EndFrame((Profiler::Now() - frameStart) / 1e6);
+        ++m_frameIndex;
+    }
+
+    void Engine::UpdateFrame(float deltaTime)
+    {
+        ENG_PROFILE_SCOPE("Engine::UpdateFrame");
+        m_time += deltaTime;
+        if (m_fixedTimestep > 0.0f)
+        {
+            m_accumulator += deltaTime;
+            int steps = 0;
+            while (m_accumulator >= m_fixedTimestep && steps < m_maxFixedSteps)
+            {
+                Simulate(m_fixedTimestep);
+                m_accumulator -= m_fixedTimestep;
+                ++steps;
+
+                // Button presses are seen by one step only, and are kept
+                // for the next frame if no step ran
+                m_inputManager.ClearStates();
+            }
+
+            // Catching up on the whole backlog would only make the next
+            // frame longer
+            if (m_accumulator >= m_fixedTimestep)
+            {
+                m_accumulator = std::fmod(m_accumulator, m_fixedTimestep);
+            }
+            m_interpolationAlpha = m_accumulator / m_fixedTimestep;
+        }
+        else
+        {
+            Simulate(deltaTime);
+            m_inputManager.ClearStates();
+            m_interpolationAlpha = 1.0f;
+        }
+
+        StageTimer timer(m_frameStats, FrameStage::LateUpdate);
+        if (m_currentScene)
+        {
+            m_currentScene->LateUpdate(deltaTime);
+        }
+
+        CameraData cameraData;
+        FrameVector<LightData> lights;
+
+        // Kept up to date by the resize callback, unlike the window size it
+        // can be read off the main thread
+        const auto& viewport = m_graphicsAPI.GetViewport();
+        const int width = viewport.width;
+        const int height = viewport.height;
+        float aspect = static_cast<float>(width) / static_cast<float>(height);
+
+        if (m_currentScene)
+        {
+            if (auto cameraObject = m_currentScene->GetMainCamera())
+            {
+                // logic for matrices
+                auto cameraComponent = cameraObject->GetComponent<CameraComponent>();
+                if (cameraComponent)
                 {
-                    // logic for matrices
-                    auto cameraComponent = cameraObject->GetComponent<CameraComponent>();
-                    if (cameraComponent)
-                    {
-                        cameraData.viewMatrix = cameraComponent->GetViewMatrix();
-                        cameraData.projectionMatrix = cameraComponent->GetProjectionMatrix(aspect);
-                        cameraData.orthoMatrix = glm::ortho(
-                            0.0f, static_cast<float>(width),
-                            0.0f, static_cast<float>(height)
-                        );
-                        cameraData.position = cameraObject->GetWorldPosition();
-                    }
+                    cameraData.viewMatrix = cameraComponent->GetViewMatrix(m_interpolationAlpha);
+                    cameraData.projectionMatrix = cameraComponent->GetProjectionMatrix(aspect);
+                    cameraData.orthoMatrix = glm::ortho(
+                        0.0f, static_cast<float>(width),
+                        0.0f, static_cast<float>(height)
+                    );
+                    cameraData.position = glm::vec3(glm::inverse(cameraData.viewMatrix)[3]);
                 }
-
-                lights = m_currentScene->CollectLights();
             }
 
-            m_rederQueue.Draw(m_graphicsAPI, cameraData, lights);
+            lights = m_currentScene->CollectLights();
+        }
 
+        m_rederQueue.EndFrame(cameraData, std::move(lights), m_time);
+    }
+
+    void Engine::DrawFrame()
+    {
+        ENG_PROFILE_SCOPE("Engine::DrawFrame");
+        StageTimer timer(m_frameStats, FrameStage::Draw);
+        m_graphicsAPI.ClearBuffers();
+        m_rederQueue.Draw(m_graphicsAPI);
+        if (m_window)
+        {
             glfwSwapBuffers(m_window);
+        }
+    }
 
-            m_inputManager.ClearStates();
+    void Engine::Simulate(float deltaTime)
+    {
+        ENG_PROFILE_SCOPE("Engine::Simulate");
+        {
+            StageTimer timer(m_frameStats, FrameStage::Physics);
+            if (m_fixedTimestep > 0.0f)
+            {
+                m_physicsManager.Step(deltaTime);
+            }
+            else
+            {
+                m_physicsManager.Update(deltaTime);
+            }
         }
 
-        m_application.reset(nullptr);
+        StageTimer timer(m_frameStats, FrameStage::Update);
+        if (m_uiInputSystem.IsActive())
+        {
+            m_uiInputSystem.Update(deltaTime);
+        }
+
+        m_application->Update(deltaTime);
     }
 
     void Engine::Destroy()
     {
+        m_jobSystem.Shutdown();
         if (m_application)
         {
             m_application->Destroy();
             m_application.reset();
+            m_graphicsAPI.ReleaseDeferredDeletes();
             glfwTerminate();
             m_window = nullptr;
         }
     }
 
+    FrameTimeReport Engine::BuildFrameTimeReport(std::vector<double>& frameTimes)
+    {
+        FrameTimeReport report;
+        if (frameTimes.empty())
+        {
+            return report;
+        }
+
+        std::sort(frameTimes.begin(), frameTimes.end());
+        double total = 0.0;
+        for (auto time : frameTimes)
+        {
+            total += time;
+        }
+
+        const size_t last = frameTimes.size() - 1;
+        report.frames = frameTimes.size();
+        report.minMs = frameTimes.front();
+        report.avgMs = total / frameTimes.size();
+        report.p50Ms = frameTimes[last * 50 / 100];
+        report.p90Ms = frameTimes[last * 90 / 100];
+        report.p99Ms = frameTimes[last * 99 / 100];
+        report.maxMs = frameTimes.back();
+        return report;
+    }
+
     void Engine::SetCursorEnabled(bool enabled)
     {
+        // GLFW only takes this from the main thread, from a worker it is
+        // applied at the end of the frame
+        if (!IsGraphicsThread())
+        {
+            m_cursorRequest = enabled ? ToggleRequest::Enable : ToggleRequest::Disable;
+            return;
+        }
+        if (!m_window)
+        {
+            return;
+        }
+
         glfwSetInputMode(m_window, GLFW_CURSOR, enabled ? GLFW_CURSOR_NORMAL : GLFW_CURSOR_DISABLED);
     }
 
+    void Engine::SetFixedTimestep(float timestep, int maxSteps)
+    {
+        m_fixedTimestep = timestep > 0.0f ? timestep : 0.0f;
+        m_maxFixedSteps = maxSteps > 0 ? maxSteps : 1;
+        m_accumulator = 0.0f;
+        m_interpolationAlpha = 1.0f;
+    }
+
+    void Engine::SetPipelined(bool pipelined)
+    {
+        // The frames can't be cleared while the main thread draws one
+        if (m_inPipelinedUpdate)
+        {
+            m_pipelinedRequest = pipelined ? ToggleRequest::Enable : ToggleRequest::Disable;
+            return;
+        }
+        if (pipelined == m_pipelined)
+        {
+            return;
+        }
+
+        // A pipelined update leaves its frame to be drawn by the next one,
+        // and the first pipelined frame would draw the last serial frame
+        // again. Neither may survive the switch, their resources can be
+        // gone by then.
+        m_rederQueue.ClearFrames();
+        m_pipelined = pipelined;
+    }
+
+    bool Engine::IsPipelined() const
+    {
+        return m_pipelined;
+    }
+
+    bool Engine::IsGraphicsThread() const
+    {
+        // Before Init there is no context to protect
+        return m_mainThreadId == std::thread::id() || std::this_thread::get_id() == m_mainThreadId;
+    }
+
+    void Engine::CheckGraphicsThread(const char* resource) const
+    {
+        if (!IsGraphicsThread())
+        {
+            std::cerr << "ERROR: " << resource << " created off the main thread, "
+                << "GL resources have to be made outside of a pipelined or parallel update" << std::endl;
+        }
+    }
+
+    float Engine::GetFixedTimestep() const
+    {
+        return m_fixedTimestep;
+    }
+
+    float Engine::GetInterpolationAlpha() const
+    {
+        return m_interpolationAlpha;
+    }
+
     void Engine::SetApplication(Application* app)
     {
         m_application.reset(app);
@@ -209,6 +498,11 @@ namespace eng
         return m_inputManager;
     }
 
+    SyntheticInput& Engine::GetSyntheticInput()
+    {
+        return m_syntheticInput;
+    }
+
     GraphicsAPI& Engine::GetGraphicsAPI()
     {
         return m_graphicsAPI;
@@ -249,8 +543,40 @@ namespace eng
         return m_uiInputSystem;
     }
 
+    JobSystem& Engine::GetJobSystem()
+    {
+        return m_jobSystem;
+    }
+
+    FrameAllocator& Engine::GetFrameAllocator()
+    {
+        return m_frameAllocator;
+    }
+
+    CostAccounting& Engine::GetCostAccounting()
+    {
+        return m_costAccounting;
+    }
+
+    FrameStats& Engine::GetFrameStats()
+    {
+        return m_frameStats;
+    }
+
     void Engine::SetScene(const std::shared_ptr<Scene>& scene)
     {
+        if (m_inPipelinedUpdate)
+        {
+            m_requestedScene = scene;
+            m_sceneRequested = true;
+            return;
+        }
+
+        // The frame that is not drawn yet points into the old scene
+        if (m_pipelined)
+        {
+            m_rederQueue.ClearFrames();
+        }
         m_currentScene = scene;
     }
 
@@ -1,5 +1,6 @@
 #pragma once
 #include "input/InputManager.h"
+#include "input/SyntheticInput.h"
 #include "graphics/GraphicsAPI.h"
 #include "graphics/Texture.h"
 #include "render/RenderQueue.h"
@@ -9,14 +10,34 @@
 #include "audio/AudioManager.h"
 #include "font/FontManager.h"
 #include "scene/components/ui/UIInputSystem.h"
+#include "jobs/JobSystem.h"
+#include "memory/FrameAllocator.h"
+#include "profiling/CostAccounting.h"
+#include "profiling/FrameStats.h"
 
+#include <atomic>
 #include <memory>
 #include <chrono>
+#include <thread>
+#include <vector>
 
 struct GLFWwindow;
 namespace eng
 {
     class Application;
+
+    // Wall clock time per frame of a run with a fixed frame count
+    struct FrameTimeReport
+    {
+        size_t frames = 0;
+        double minMs = 0.0;
+        double avgMs = 0.0;
+        double p50Ms = 0.0;
+        double p90Ms = 0.0;
+        double p99Ms = 0.0;
+        double maxMs = 0.0;
+    };
+
     class Engine
     {
     public:
@@ -30,14 +51,45 @@ namespace eng
         Engine& operator=(Engine&&) = delete;
 
     public:
-        bool Init(int width, int height);
+        // Headless runs without a window, GL context or audio device, see
+        // NullGraphicsBackend. Input then only comes from SyntheticInput.
+        bool Init(int width, int height, bool headless = false);
+        bool IsHeadless() const;
         void Run();
+        // Runs frameCount frames, each simulating deltaTime no matter how
+        // long it took, so runs of the same input are repeatable
+        FrameTimeReport Run(size_t frameCount, float deltaTime);
         void Destroy();
         void SetCursorEnabled(bool enabled);
 
+        // Runs the simulation in steps of the given length, 0 goes back to
+        // one step per frame. At most maxSteps run per frame, the rest of a
+        // long frame is dropped.
+        void SetFixedTimestep(float timestep, int maxSteps = 5);
+        float GetFixedTimestep() const;
+        // How far the frame is between the last two fixed steps, 1 without
+        // a fixed timestep
+        float GetInterpolationAlpha() const;
+
+        // Simulates the next frame on a worker while the main thread draws
+        // the previous one, at the cost of one frame of latency. GL objects
+        // can then only be created outside of the update, see
+        // CheckGraphicsThread, their deletes wait for the end of the frame
+        // and the scene keeps destroyed objects until the draw is done.
+        // Switching drops the frame that is not drawn yet, from a pipelined
+        // update the switch happens once the update is over.
+        void SetPipelined(bool pipelined);
+        bool IsPipelined() const;
+        // The thread that owns the GL context and the window
+        bool IsGraphicsThread() const;
+        // Called by the GL resources when they are created. Logs an error
+        // off the main thread, where there is no GL context.
+        void CheckGraphicsThread(const char* resource) const;
+
         void SetApplication(Application* app);
         Application* GetApplication();
         InputManager& GetInputManager();
+        SyntheticInput& GetSyntheticInput();
         GraphicsAPI& GetGraphicsAPI();
         RenderQueue& GetRenderQueue();
         FileSystem& GetFileSystem();
@@ -46,15 +98,56 @@ namespace eng
         AudioManager& GetAudioManager();
         FontManager& GetFontManager();
         UIInputSystem& GetUIInputSystem();
+        JobSystem& GetJobSystem();
+        FrameAllocator& GetFrameAllocator();
+        // Scene update time per component and GameObject type
+        CostAccounting& GetCostAccounting();
+        // Frame and stage times of the recent frames, with budgets
+        FrameStats& GetFrameStats();
 
+        // From a pipelined update the scene is switched once the update is
+        // over, so the old one is not freed while its frame is drawn
         void SetScene(const std::shared_ptr<Scene>& scene);
         const std::shared_ptr<Scene>& GetScene();
 
+    private:
+        // Changes asked for by a pipelined update, applied on the main
+        // thread once the update is over
+        enum class ToggleRequest
+        {
+            None,
+            Enable,
+            Disable
+        };
+
+        bool InitWindow(int width, int height);
+        void RunFrame(float deltaTime);
+        void UpdateFrame(float deltaTime);
+        void Simulate(float deltaTime);
+        void DrawFrame();
+        static FrameTimeReport BuildFrameTimeReport(std::vector<double>& frameTimes);
+
     private:
         std::unique_ptr<Application> m_application;
         std::chrono::steady_clock::time_point m_lastTimePoint;
+        float m_fixedTimestep = 0.0f;
+        int m_maxFixedSteps = 5;
+        float m_accumulator = 0.0f;
+        float m_interpolationAlpha = 1.0f;
+        // Seconds of all updated frames, the shaders' uTime
+        float m_time = 0.0f;
+        bool m_pipelined = false;
+        // Set on the main thread around the update it hands to a worker
+        bool m_inPipelinedUpdate = false;
+        bool m_headless = false;
+        uint64_t m_frameIndex = 0;
+        std::thread::id m_mainThreadId;
+        // Any worker can ask for it
+        std::atomic<ToggleRequest> m_cursorRequest{ ToggleRequest::None };
+        ToggleRequest m_pipelinedRequest = ToggleRequest::None;
         GLFWwindow* m_window = nullptr;
         InputManager m_inputManager;
+        SyntheticInput m_syntheticInput;
         GraphicsAPI m_graphicsAPI;
         RenderQueue m_rederQueue;
         FileSystem m_fileSystem;
@@ -63,6 +156,12 @@ namespace eng
         AudioManager m_audioManager;
         FontManager m_fontManager;
         UIInputSystem m_uiInputSystem;
+        JobSystem m_jobSystem;
+        FrameAllocator m_frameAllocator;
+        CostAccounting m_costAccounting;
+        FrameStats m_frameStats;
         std::shared_ptr<Scene> m_currentScene;
+        std::shared_ptr<Scene> m_requestedScene;
+        bool m_sceneRequested = false;
     };
 }
\ No newline at end of file
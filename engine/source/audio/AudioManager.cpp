@@ -15,11 +15,31 @@ namespace eng
         {
             ma_engine_uninit(m_engine.get());
         }
+        if (m_context)
+        {
+            ma_context_uninit(m_context.get());
+        }
     }
 
-    bool AudioManager::Init()
+    bool AudioManager::Init(bool nullDevice)
     {
-        auto result = ma_engine_init(nullptr, m_engine.get());
+        if (!nullDevice)
+        {
+            auto result = ma_engine_init(nullptr, m_engine.get());
+            return result == MA_SUCCESS;
+        }
+
+        m_context = std::make_unique<ma_context>();
+        ma_backend backends[] = { ma_backend_null };
+        if (ma_context_init(backends, 1, nullptr, m_context.get()) != MA_SUCCESS)
+        {
+            m_context.reset();
+            return false;
+        }
+
+        ma_engine_config config = ma_engine_config_init();
+        config.pContext = m_context.get();
+        auto result = ma_engine_init(&config, m_engine.get());
         return result == MA_SUCCESS;
     }
 
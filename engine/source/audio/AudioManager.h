@@ -4,6 +4,7 @@
 #include <memory>
 
 struct ma_engine;
+struct ma_context;
 
 namespace eng
 {
@@ -13,12 +14,15 @@ namespace eng
         AudioManager();
         ~AudioManager();
 
-        bool Init();
+        // The null device plays nothing and needs no audio hardware
+        bool Init(bool nullDevice = false);
         ma_engine* GetEngine();
 
         void SetListenerPosition(const glm::vec3& pos);
 
     private:
         std::unique_ptr<ma_engine> m_engine;
+        // Only set for the null device
+        std::unique_ptr<ma_context> m_context;
     };
 }
\ No newline at end of file
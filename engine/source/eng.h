@@ -3,15 +3,20 @@
 #include "Application.h"
 #include "Engine.h"
 #include "input/InputManager.h"
+#include "input/SyntheticInput.h"
 #include "graphics/ShaderProgram.h"
 #include "graphics/GraphicsAPI.h"
 #include "graphics/VertexLayout.h"
 #include "graphics/Texture.h"
+#include "graphics/NullGraphicsBackend.h"
 #include "render/Material.h"
 #include "render/Mesh.h"
 #include "render/RenderQueue.h"
+#include "render/Frustum.h"
 #include "scene/GameObject.h"
 #include "scene/Scene.h"
+#include "scene/EntityHandle.h"
+#include "scene/TransformStore.h"
 #include "scene/Component.h"
 #include "scene/components/MeshComponent.h"
 #include "scene/components/CameraComponent.h"
@@ -25,10 +30,17 @@
 #include "scene/components/ui/UIElementComponent.h"
 #include "scene/components/ui/CanvasComponent.h"
 #include "scene/components/ui/TextComponent.h"
+#include "scene/components/ui/FrameStatsComponent.h"
 #include "scene/components/ui/ButtonComponent.h"
 #include "scene/components/ui/UIInputSystem.h"
 #include "scene/components/ui/RectTransformComponent.h"
 #include "io/FileSystem.h"
+#include "memory/PoolAllocator.h"
+#include "memory/FrameAllocator.h"
+#include "profiling/Profiler.h"
+#include "profiling/CostAccounting.h"
+#include "profiling/FrameStats.h"
+#include "jobs/JobSystem.h"
 #include "physics/PhysicsManager.h"
 #include "physics/Collider.h"
 #include "physics/RigidBody.h"
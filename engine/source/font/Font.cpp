@@ -7,6 +7,11 @@ namespace eng
         return m_size;
     }
 
+    int Font::GetLineHeight() const
+    {
+        return m_lineHeight;
+    }
+
     const GlyphDescription& Font::GetGlyphDescription(char asciiCode) const
     {
         return m_descriptions[static_cast<unsigned char>(asciiCode)];
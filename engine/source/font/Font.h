@@ -21,11 +21,14 @@ namespace eng
     {
     public:
         int GetSize() const;
+        // Distance between the baselines of two lines, in pixels
+        int GetLineHeight() const;
         const GlyphDescription& GetGlyphDescription(char asciiCode) const;
         const std::shared_ptr<Texture>& GetTexture() const;
 
     private:
         int m_size = 0;
+        int m_lineHeight = 0;
         GlyphDescription m_descriptions[128];
         std::shared_ptr<Texture> m_texture;
 
@@ -127,6 +127,7 @@ namespace eng
 
         font->m_texture = std::make_shared<Texture>(textureWidth, textureHeight, 4, atlas);
         font->m_size = size;
+        font->m_lineHeight = lineHeight;
 
         m_fonts[path][size] = font;
 
@@ -2,6 +2,7 @@
 #include "graphics/ShaderProgram.h"
 #include "render/Material.h"
 #include "render/Mesh.h"
+#include "Engine.h"
 #include <iostream>
 
 namespace eng
@@ -9,6 +10,12 @@ namespace eng
     bool GraphicsAPI::Init()
     {
         glEnable(GL_DEPTH_TEST);
+
+        glGenBuffers(1, &m_frameUniformBuffer);
+        glBindBuffer(GL_UNIFORM_BUFFER, m_frameUniformBuffer);
+        glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameUniforms), nullptr, GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        glBindBufferBase(GL_UNIFORM_BUFFER, FrameUniformsBinding, m_frameUniformBuffer);
         return true;
     }
 
@@ -23,6 +30,28 @@ namespace eng
         }
 
 
+        GLuint shaderProgramID = CompileShaderProgram(vertexSource, fragmentSource);
+        if (shaderProgramID == 0)
+        {
+            return nullptr;
+        }
+
+        auto shaderProgram = std::make_shared<ShaderProgram>(shaderProgramID);
+        if (vertexSource.find("INSTANCED") != std::string::npos)
+        {
+            GLuint variantID = CompileShaderProgram(AddDefine(vertexSource, "INSTANCED"), fragmentSource);
+            if (variantID != 0)
+            {
+                shaderProgram->SetInstancedVariant(std::make_shared<ShaderProgram>(variantID));
+            }
+        }
+        m_shaderCache.emplace(key, shaderProgram);
+
+        return shaderProgram;
+    }
+
+    GLuint GraphicsAPI::CompileShaderProgram(const std::string& vertexSource, const std::string& fragmentSource)
+    {
         GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
         const char* vertexShaderCStr = vertexSource.c_str();
         glShaderSource(vertexShader, 1, &vertexShaderCStr, nullptr);
@@ -35,7 +64,7 @@ namespace eng
             char infoLog[512];
             glGetShaderInfoLog(vertexShader, 512, nullptr, infoLog);
             std::cerr << "ERROR:VERTEX_SHADER_COMPILATION_FAILED: " << infoLog << std::endl;
-            return nullptr;
+            return 0;
         }
 
         GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
@@ -49,7 +78,7 @@ namespace eng
             char infoLog[512];
             glGetShaderInfoLog(fragmentShader, 512, nullptr, infoLog);
             std::cerr << "ERROR:FRAGMENT_SHADER_COMPILATION_FAILED: " << infoLog << std::endl;
-            return nullptr;
+            return 0;
         }
 
         GLuint shaderProgramID = glCreateProgram();
@@ -63,16 +92,40 @@ namespace eng
             char infoLog[512];
             glGetProgramInfoLog(shaderProgramID, 512, nullptr, infoLog);
             std::cerr << "ERROR:SHADER_PROGRAM_LINKING_FAILED: " << infoLog << std::endl;
-            return nullptr;
+            return 0;
         }
 
         glDeleteShader(vertexShader);
         glDeleteShader(fragmentShader);
 
-        auto shaderProgram = std::make_shared<ShaderProgram>(shaderProgramID);
-        m_shaderCache.emplace(key, shaderProgram);
+        const GLuint frameDataIndex = glGetUniformBlockIndex(shaderProgramID, "FrameData");
+        if (frameDataIndex != GL_INVALID_INDEX)
+        {
+            glUniformBlockBinding(shaderProgramID, frameDataIndex, FrameUniformsBinding);
+        }
 
-        return shaderProgram;
+        return shaderProgramID;
+    }
+
+    std::string GraphicsAPI::AddDefine(const std::string& source, const std::string& define)
+    {
+        // Defines have to follow the #version line
+        const std::string line = "#define " + define + "\n";
+        const size_t version = source.find("#version");
+        if (version == std::string::npos)
+        {
+            return line + source;
+        }
+
+        const size_t lineEnd = source.find('\n', version);
+        if (lineEnd == std::string::npos)
+        {
+            return source + "\n" + line;
+        }
+
+        std::string result = source;
+        result.insert(lineEnd + 1, line);
+        return result;
     }
 
     const std::shared_ptr<ShaderProgram>& GraphicsAPI::GetDefaultShaderProgram()
@@ -90,9 +143,27 @@ namespace eng
             out vec3 vNormal;
             out vec3 vFragPos;
         
+            struct Light
+            {
+                vec3 color;
+                vec3 direction;
+            };
+
+            layout (std140) uniform FrameData
+            {
+                mat4 uView;
+                mat4 uProjection;
+                vec3 uCameraPos;
+                float uTime;
+                Light uLight;
+            };
+
+            #ifdef INSTANCED
+            layout (location = 4) in mat4 instanceModel;
+            #define uModel instanceModel
+            #else
             uniform mat4 uModel;
-            uniform mat4 uView;
-            uniform mat4 uProjection;
+            #endif
         
             void main()
             {
@@ -112,8 +183,14 @@ namespace eng
                 vec3 direction;
             };
 
-            uniform Light uLight;
-            uniform vec3 uCameraPos;
+            layout (std140) uniform FrameData
+            {
+                mat4 uView;
+                mat4 uProjection;
+                vec3 uCameraPos;
+                float uTime;
+                Light uLight;
+            };
 
             out vec4 FragColor;
 
@@ -276,6 +353,59 @@ namespace eng
         return EBO;
     }
 
+    void GraphicsAPI::UpdateVertexBuffer(GLuint buffer, const void* data, size_t size)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        glBufferData(GL_ARRAY_BUFFER, size, data, GL_STREAM_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    void GraphicsAPI::UpdateFrameUniforms(const FrameUniforms& uniforms)
+    {
+        glBindBuffer(GL_UNIFORM_BUFFER, m_frameUniformBuffer);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameUniforms), &uniforms);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    }
+
+    void GraphicsAPI::DeleteTexture(GLuint texture)
+    {
+        if (!Engine::GetInstance().IsGraphicsThread())
+        {
+            std::lock_guard<std::mutex> lock(m_deferredDeleteMutex);
+            m_texturesToDelete.push_back(texture);
+            return;
+        }
+
+        glDeleteTextures(1, &texture);
+    }
+
+    void GraphicsAPI::DeleteShaderProgram(GLuint program)
+    {
+        if (!Engine::GetInstance().IsGraphicsThread())
+        {
+            std::lock_guard<std::mutex> lock(m_deferredDeleteMutex);
+            m_programsToDelete.push_back(program);
+            return;
+        }
+
+        glDeleteProgram(program);
+    }
+
+    void GraphicsAPI::ReleaseDeferredDeletes()
+    {
+        std::lock_guard<std::mutex> lock(m_deferredDeleteMutex);
+        if (!m_texturesToDelete.empty())
+        {
+            glDeleteTextures(static_cast<GLsizei>(m_texturesToDelete.size()), m_texturesToDelete.data());
+            m_texturesToDelete.clear();
+        }
+        for (auto program : m_programsToDelete)
+        {
+            glDeleteProgram(program);
+        }
+        m_programsToDelete.clear();
+    }
+
     void GraphicsAPI::SetClearColor(float r, float g, float b, float a)
     {
         glClearColor(r, g, b, a);
@@ -1,8 +1,11 @@
 #pragma once
 
 #include <glad/glad.h>
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -51,10 +54,40 @@ namespace eng
         }
     };
 
+    // Shader data that stays the same for a whole frame, laid out like the
+    // std140 FrameData uniform block:
+    //
+    //     struct Light { vec3 color; vec3 direction; };
+    //     layout (std140) uniform FrameData
+    //     {
+    //         mat4 uView;
+    //         mat4 uProjection;
+    //         vec3 uCameraPos;
+    //         float uTime;
+    //         Light uLight;
+    //     };
+    struct FrameUniforms
+    {
+        glm::mat4 view = glm::mat4(1.0f);
+        glm::mat4 projection = glm::mat4(1.0f);
+        glm::vec3 cameraPos = glm::vec3(0.0f);
+        float time = 0.0f;
+        glm::vec3 lightColor = glm::vec3(0.0f);
+        float padding0 = 0.0f;
+        glm::vec3 lightDirection = glm::vec3(0.0f, -1.0f, 0.0f);
+        float padding1 = 0.0f;
+    };
+    static_assert(sizeof(FrameUniforms) == 176, "FrameUniforms has to match the std140 layout of FrameData");
+
     class GraphicsAPI
     {
     public:
+        static constexpr GLuint FrameUniformsBinding = 0;
+
         bool Init();
+        // Programs with a FrameData block get it bound to the frame
+        // uniforms. Vertex shaders that check for INSTANCED get an
+        // instanced variant, see ShaderProgram::GetInstancedVariant
         std::shared_ptr<ShaderProgram> CreateShaderProgram(const std::string& vertexSource, 
             const std::string& fragmentSource);
         const std::shared_ptr<ShaderProgram>& GetDefaultShaderProgram();
@@ -62,6 +95,16 @@ namespace eng
         const std::shared_ptr<ShaderProgram>& GetDefaultUIShaderProgram();
         GLuint CreateVertexBuffer(const std::vector<float>& vertices);
         GLuint CreateIndexBuffer(const std::vector<uint32_t>& indices);
+        // Replaces the whole contents, for data written every frame
+        void UpdateVertexBuffer(GLuint buffer, const void* data, size_t size);
+        // Uploaded once per frame, before the draws that read it
+        void UpdateFrameUniforms(const FrameUniforms& uniforms);
+        // Off the main thread, like in a pipelined update, the delete waits
+        // for ReleaseDeferredDeletes
+        void DeleteTexture(GLuint texture);
+        void DeleteShaderProgram(GLuint program);
+        // Called by the engine on the main thread once the frame is drawn
+        void ReleaseDeferredDeletes();
 
         void SetClearColor(float r, float g, float b, float a);
         void ClearBuffers();
@@ -76,11 +119,20 @@ namespace eng
         void UnbindMesh(Mesh* mesh);
         void DrawMesh(Mesh* mesh);
 
+    private:
+        // Returns 0 and logs the error if compiling or linking failed
+        GLuint CompileShaderProgram(const std::string& vertexSource, const std::string& fragmentSource);
+        static std::string AddDefine(const std::string& source, const std::string& define);
+
     private:
         Rect m_viewport;
         std::shared_ptr<ShaderProgram> m_defaultShaderProgram;
         std::shared_ptr<ShaderProgram> m_default2DShaderProgram;
         std::shared_ptr<ShaderProgram> m_defaultUIShaderProgram;
         std::unordered_map<ShaderKey, std::shared_ptr<ShaderProgram>, ShaderKeyHash> m_shaderCache;
+        GLuint m_frameUniformBuffer = 0;
+        std::mutex m_deferredDeleteMutex;
+        std::vector<GLuint> m_texturesToDelete;
+        std::vector<GLuint> m_programsToDelete;
     };
 }
\ No newline at end of file
@@ -0,0 +1,537 @@
+#include "graphics/NullGraphicsBackend.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+
+namespace eng
+{
+    NullGraphicsStats NullGraphicsBackend::s_stats;
+    GLuint NullGraphicsBackend::s_nextId = 1;
+    std::vector<unsigned char> NullGraphicsBackend::s_lastBufferData;
+    std::unordered_map<GLuint, std::string> NullGraphicsBackend::s_shaderSources;
+    std::unordered_map<GLuint, std::vector<GLuint>> NullGraphicsBackend::s_attachedShaders;
+    std::unordered_map<GLuint, std::vector<NullGraphicsBackend::Uniform>> NullGraphicsBackend::s_programUniforms;
+
+    static GLenum GetUniformType(const std::string& type)
+    {
+        static const std::unordered_map<std::string, GLenum> s_types =
+        {
+            { "int", GL_INT },
+            { "bool", GL_BOOL },
+            { "float", GL_FLOAT },
+            { "vec2", GL_FLOAT_VEC2 },
+            { "vec3", GL_FLOAT_VEC3 },
+            { "vec4", GL_FLOAT_VEC4 },
+            { "mat3", GL_FLOAT_MAT3 },
+            { "mat4", GL_FLOAT_MAT4 },
+            { "sampler2D", GL_SAMPLER_2D },
+            { "samplerCube", GL_SAMPLER_CUBE }
+        };
+        auto it = s_types.find(type);
+        return it != s_types.end() ? it->second : GL_FLOAT;
+    }
+
+    void NullGraphicsBackend::Install()
+    {
+        glad_glGenBuffers = GenBuffers;
+        glad_glGenVertexArrays = GenVertexArrays;
+        glad_glGenTextures = GenTextures;
+        glad_glBufferData = BufferData;
+        glad_glBufferSubData = BufferSubData;
+        glad_glTexImage2D = TexImage2D;
+        glad_glCreateShader = CreateShader;
+        glad_glCreateProgram = CreateProgram;
+        glad_glShaderSource = ShaderSource;
+        glad_glAttachShader = AttachShader;
+        glad_glLinkProgram = LinkProgram;
+        glad_glDeleteShader = DeleteShader;
+        glad_glDeleteProgram = DeleteProgram;
+        glad_glGetShaderiv = GetShaderiv;
+        glad_glGetProgramiv = GetProgramiv;
+        glad_glGetShaderInfoLog = GetInfoLog;
+        glad_glGetProgramInfoLog = GetInfoLog;
+        glad_glGetUniformLocation = GetUniformLocation;
+        glad_glGetUniformBlockIndex = GetUniformBlockIndex;
+        glad_glGetActiveUniform = GetActiveUniform;
+        glad_glUseProgram = UseProgram;
+        glad_glBindTexture = BindTexture;
+        glad_glUniform1i = Uniform1i;
+        glad_glUniform1f = Uniform1f;
+        glad_glUniform2f = Uniform2f;
+        glad_glUniform3fv = UniformVector;
+        glad_glUniform4fv = UniformVector;
+        glad_glUniformMatrix4fv = UniformMatrix;
+        glad_glDrawArrays = DrawArrays;
+        glad_glDrawElements = DrawElements;
+        glad_glDrawArraysInstanced = DrawArraysInstanced;
+        glad_glDrawElementsInstanced = DrawElementsInstanced;
+
+        glad_glEnable = IgnoreEnum;
+        glad_glDisable = IgnoreEnum;
+        glad_glClear = IgnoreEnum;
+        glad_glActiveTexture = IgnoreEnum;
+        glad_glGenerateMipmap = IgnoreEnum;
+        glad_glBindVertexArray = IgnoreId;
+        glad_glEnableVertexAttribArray = IgnoreId;
+        glad_glDisableVertexAttribArray = IgnoreId;
+        glad_glCompileShader = IgnoreId;
+        glad_glBindBuffer = IgnorePair;
+        glad_glBlendFunc = IgnorePair;
+        glad_glVertexAttribDivisor = IgnorePair;
+        glad_glBindBufferBase = IgnoreTriple;
+        glad_glUniformBlockBinding = IgnoreTriple;
+        glad_glTexParameteri = IgnoreTexParameter;
+        glad_glVertexAttribPointer = IgnoreVertexAttribPointer;
+        glad_glViewport = IgnoreViewport;
+        glad_glDeleteTextures = IgnoreDelete;
+        glad_glClearColor = IgnoreColor;
+    }
+
+    const NullGraphicsStats& NullGraphicsBackend::GetStats()
+    {
+        return s_stats;
+    }
+
+    void NullGraphicsBackend::ResetStats()
+    {
+        s_stats = NullGraphicsStats();
+    }
+
+    const std::vector<unsigned char>& NullGraphicsBackend::GetLastBufferData()
+    {
+        return s_lastBufferData;
+    }
+
+    void APIENTRY NullGraphicsBackend::GenBuffers(GLsizei n, GLuint* buffers)
+    {
+        for (GLsizei i = 0; i < n; ++i)
+        {
+            buffers[i] = s_nextId++;
+        }
+        s_stats.buffersCreated += n;
+    }
+
+    void APIENTRY NullGraphicsBackend::GenVertexArrays(GLsizei n, GLuint* arrays)
+    {
+        for (GLsizei i = 0; i < n; ++i)
+        {
+            arrays[i] = s_nextId++;
+        }
+    }
+
+    void APIENTRY NullGraphicsBackend::GenTextures(GLsizei n, GLuint* textures)
+    {
+        for (GLsizei i = 0; i < n; ++i)
+        {
+            textures[i] = s_nextId++;
+        }
+        s_stats.texturesCreated += n;
+    }
+
+    void APIENTRY NullGraphicsBackend::BufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage)
+    {
+        ++s_stats.bufferUploads;
+        s_stats.bufferBytes += static_cast<size_t>(size);
+        const auto bytes = static_cast<const unsigned char*>(data);
+        if (bytes)
+        {
+            s_lastBufferData.assign(bytes, bytes + size);
+        }
+        else
+        {
+            s_lastBufferData.clear();
+        }
+    }
+
+    void APIENTRY NullGraphicsBackend::TexImage2D(GLenum target, GLint level, GLint internalFormat, GLsizei width,
+        GLsizei height, GLint border, GLenum format, GLenum type, const void* pixels)
+    {
+        const size_t channels = format == GL_RGBA ? 4 : format == GL_RGB ? 3 : format == GL_RG ? 2 : 1;
+        s_stats.textureBytes += static_cast<size_t>(width) * height * channels;
+    }
+
+    void APIENTRY NullGraphicsBackend::BufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data)
+    {
+        ++s_stats.bufferUploads;
+        s_stats.bufferBytes += static_cast<size_t>(size);
+    }
+
+    GLuint APIENTRY NullGraphicsBackend::CreateShader(GLenum type)
+    {
+        ++s_stats.shadersCreated;
+        return s_nextId++;
+    }
+
+    GLuint APIENTRY NullGraphicsBackend::CreateProgram()
+    {
+        ++s_stats.programsCreated;
+        return s_nextId++;
+    }
+
+    void APIENTRY NullGraphicsBackend::ShaderSource(GLuint shader, GLsizei count, const GLchar* const* string,
+        const GLint* length)
+    {
+        auto& source = s_shaderSources[shader];
+        source.clear();
+        for (GLsizei i = 0; i < count; ++i)
+        {
+            if (length && length[i] >= 0)
+            {
+                source.append(string[i], static_cast<size_t>(length[i]));
+            }
+            else
+            {
+                source.append(string[i]);
+            }
+        }
+    }
+
+    void APIENTRY NullGraphicsBackend::AttachShader(GLuint program, GLuint shader)
+    {
+        s_attachedShaders[program].push_back(shader);
+    }
+
+    void APIENTRY NullGraphicsBackend::LinkProgram(GLuint program)
+    {
+        // A uniform declared in several stages is one uniform of the program
+        auto& uniforms = s_programUniforms[program];
+        uniforms.clear();
+        GLint nextLocation = 0;
+        for (auto shader : s_attachedShaders[program])
+        {
+            for (auto& uniform : ParseUniforms(s_shaderSources[shader]))
+            {
+                auto sameName = [&uniform](const Uniform& other) { return other.name == uniform.name; };
+                if (std::find_if(uniforms.begin(), uniforms.end(), sameName) != uniforms.end())
+                {
+                    continue;
+                }
+                uniform.location = nextLocation;
+                nextLocation += uniform.size;
+                uniforms.push_back(uniform);
+            }
+        }
+    }
+
+    void APIENTRY NullGraphicsBackend::DeleteShader(GLuint shader)
+    {
+        s_shaderSources.erase(shader);
+    }
+
+    void APIENTRY NullGraphicsBackend::DeleteProgram(GLuint program)
+    {
+        s_attachedShaders.erase(program);
+        s_programUniforms.erase(program);
+    }
+
+    void APIENTRY NullGraphicsBackend::GetShaderiv(GLuint shader, GLenum pname, GLint* params)
+    {
+        *params = pname == GL_COMPILE_STATUS ? GL_TRUE : 0;
+    }
+
+    void APIENTRY NullGraphicsBackend::GetProgramiv(GLuint program, GLenum pname, GLint* params)
+    {
+        *params = 0;
+        if (pname == GL_LINK_STATUS)
+        {
+            *params = GL_TRUE;
+            return;
+        }
+
+        auto it = s_programUniforms.find(program);
+        if (it == s_programUniforms.end())
+        {
+            return;
+        }
+        if (pname == GL_ACTIVE_UNIFORMS)
+        {
+            *params = static_cast<GLint>(it->second.size());
+        }
+        else if (pname == GL_ACTIVE_UNIFORM_MAX_LENGTH)
+        {
+            for (const auto& uniform : it->second)
+            {
+                // Counts the terminating null like a driver does
+                *params = std::max(*params, static_cast<GLint>(uniform.name.size() + 1));
+            }
+        }
+    }
+
+    void APIENTRY NullGraphicsBackend::GetInfoLog(GLuint object, GLsizei bufSize, GLsizei* length, GLchar* infoLog)
+    {
+        if (length)
+        {
+            *length = 0;
+        }
+        if (infoLog && bufSize > 0)
+        {
+            infoLog[0] = '\0';
+        }
+    }
+
+    GLint APIENTRY NullGraphicsBackend::GetUniformLocation(GLuint program, const GLchar* name)
+    {
+        auto it = s_programUniforms.find(program);
+        if (it == s_programUniforms.end())
+        {
+            return -1;
+        }
+
+        const std::string query = name;
+        for (const auto& uniform : it->second)
+        {
+            if (uniform.name == query)
+            {
+                return uniform.location;
+            }
+
+            // Arrays are declared as name[0], their elements are also found
+            // by the bare name and by name[i]
+            const size_t bracket = uniform.name.find('[');
+            if (bracket == std::string::npos || query.compare(0, bracket, uniform.name, 0, bracket) != 0)
+            {
+                continue;
+            }
+            if (query.size() == bracket)
+            {
+                return uniform.location;
+            }
+            if (query[bracket] == '[')
+            {
+                const int element = std::atoi(query.c_str() + bracket + 1);
+                if (element >= 0 && element < uniform.size)
+                {
+                    return uniform.location + element;
+                }
+            }
+        }
+        return -1;
+    }
+
+    GLuint APIENTRY NullGraphicsBackend::GetUniformBlockIndex(GLuint program, const GLchar* name)
+    {
+        return 0;
+    }
+
+    void APIENTRY NullGraphicsBackend::GetActiveUniform(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length,
+        GLint* size, GLenum* type, GLchar* name)
+    {
+        auto it = s_programUniforms.find(program);
+        const Uniform* uniform = it != s_programUniforms.end() && index < it->second.size() ? &it->second[index] : nullptr;
+
+        const size_t nameLength = uniform && bufSize > 0 ?
+            std::min(uniform->name.size(), static_cast<size_t>(bufSize - 1)) : 0;
+        if (length)
+        {
+            *length = static_cast<GLsizei>(nameLength);
+        }
+        if (name && bufSize > 0)
+        {
+            if (uniform)
+            {
+                std::memcpy(name, uniform->name.data(), nameLength);
+            }
+            name[nameLength] = '\0';
+        }
+        if (size)
+        {
+            *size = uniform ? uniform->size : 0;
+        }
+        if (type)
+        {
+            *type = uniform ? uniform->type : 0;
+        }
+    }
+
+    void APIENTRY NullGraphicsBackend::UseProgram(GLuint program)
+    {
+        ++s_stats.programBinds;
+    }
+
+    void APIENTRY NullGraphicsBackend::BindTexture(GLenum target, GLuint texture)
+    {
+        ++s_stats.textureBinds;
+    }
+
+    void APIENTRY NullGraphicsBackend::Uniform1i(GLint location, GLint v0)
+    {
+        ++s_stats.uniformUploads;
+    }
+
+    void APIENTRY NullGraphicsBackend::Uniform1f(GLint location, GLfloat v0)
+    {
+        ++s_stats.uniformUploads;
+    }
+
+    void APIENTRY NullGraphicsBackend::Uniform2f(GLint location, GLfloat v0, GLfloat v1)
+    {
+        ++s_stats.uniformUploads;
+    }
+
+    void APIENTRY NullGraphicsBackend::UniformVector(GLint location, GLsizei count, const GLfloat* value)
+    {
+        ++s_stats.uniformUploads;
+    }
+
+    void APIENTRY NullGraphicsBackend::UniformMatrix(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+    {
+        ++s_stats.uniformUploads;
+    }
+
+    void APIENTRY NullGraphicsBackend::DrawArrays(GLenum mode, GLint first, GLsizei count)
+    {
+        ++s_stats.drawCalls;
+        s_stats.verticesDrawn += static_cast<size_t>(count);
+    }
+
+    void APIENTRY NullGraphicsBackend::DrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices)
+    {
+        ++s_stats.drawCalls;
+        s_stats.verticesDrawn += static_cast<size_t>(count);
+    }
+
+    void APIENTRY NullGraphicsBackend::DrawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instanceCount)
+    {
+        ++s_stats.drawCalls;
+        s_stats.instancesDrawn += static_cast<size_t>(instanceCount);
+        s_stats.verticesDrawn += static_cast<size_t>(count) * instanceCount;
+    }
+
+    void APIENTRY NullGraphicsBackend::DrawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void* indices,
+        GLsizei instanceCount)
+    {
+        ++s_stats.drawCalls;
+        s_stats.instancesDrawn += static_cast<size_t>(instanceCount);
+        s_stats.verticesDrawn += static_cast<size_t>(count) * instanceCount;
+    }
+
+    void APIENTRY NullGraphicsBackend::IgnoreEnum(GLenum value)
+    {
+    }
+
+    void APIENTRY NullGraphicsBackend::IgnoreId(GLuint id)
+    {
+    }
+
+    void APIENTRY NullGraphicsBackend::IgnorePair(GLuint a, GLuint b)
+    {
+    }
+
+    void APIENTRY NullGraphicsBackend::IgnoreTriple(GLuint a, GLuint b, GLuint c)
+    {
+    }
+
+    void APIENTRY NullGraphicsBackend::IgnoreTexParameter(GLenum target, GLenum pname, GLint param)
+    {
+    }
+
+    void APIENTRY NullGraphicsBackend::IgnoreVertexAttribPointer(GLuint index, GLint size, GLenum type,
+        GLboolean normalized, GLsizei stride, const void* pointer)
+    {
+    }
+
+    void APIENTRY NullGraphicsBackend::IgnoreViewport(GLint x, GLint y, GLsizei width, GLsizei height)
+    {
+    }
+
+    void APIENTRY NullGraphicsBackend::IgnoreDelete(GLsizei n, const GLuint* ids)
+    {
+    }
+
+    void APIENTRY NullGraphicsBackend::IgnoreColor(GLfloat r, GLfloat g, GLfloat b, GLfloat a)
+    {
+    }
+
+    std::vector<NullGraphicsBackend::Uniform> NullGraphicsBackend::ParseUniforms(const std::string& source)
+    {
+        // Words and single punctuation characters. Comments and preprocessor
+        // lines are dropped, so both sides of an #ifdef are declared.
+        std::vector<std::string> tokens;
+        size_t i = 0;
+        while (i < source.size())
+        {
+            const char c = source[i];
+            if (std::isspace(static_cast<unsigned char>(c)))
+            {
+                ++i;
+            }
+            else if (c == '#' || source.compare(i, 2, "//") == 0)
+            {
+                i = source.find('\n', i);
+            }
+            else if (source.compare(i, 2, "/*") == 0)
+            {
+                i = source.find("*/", i);
+                i = i == std::string::npos ? i : i + 2;
+            }
+            else if (std::isalnum(static_cast<unsigned char>(c)) || c == '_')
+            {
+                const size_t begin = i;
+                while (i < source.size() && (std::isalnum(static_cast<unsigned char>(source[i])) || source[i] == '_'))
+                {
+                    ++i;
+                }
+                tokens.push_back(source.substr(begin, i - begin));
+            }
+            else
+            {
+                tokens.push_back(std::string(1, c));
+                ++i;
+            }
+        }
+
+        std::vector<Uniform> uniforms;
+        for (size_t t = 0; t < tokens.size(); ++t)
+        {
+            if (tokens[t] != "uniform")
+            {
+                continue;
+            }
+
+            size_t next = t + 1;
+            while (next < tokens.size() && (tokens[next] == "highp" || tokens[next] == "mediump" || tokens[next] == "lowp"))
+            {
+                ++next;
+            }
+            if (next + 1 >= tokens.size())
+            {
+                break;
+            }
+
+            // Block members are bound through the block and have no location
+            if (tokens[next + 1] == "{")
+            {
+                t = next + 1;
+                while (t < tokens.size() && tokens[t] != "}")
+                {
+                    ++t;
+                }
+                continue;
+            }
+
+            // One declaration can name several uniforms, "uniform vec2 a, b[4];"
+            const GLenum type = GetUniformType(tokens[next]);
+            for (t = next + 1; t < tokens.size() && tokens[t] != ";"; ++t)
+            {
+                if (tokens[t] == ",")
+                {
+                    continue;
+                }
+
+                Uniform uniform;
+                uniform.name = tokens[t];
+                uniform.type = type;
+                if (t + 3 < tokens.size() && tokens[t + 1] == "[" && tokens[t + 3] == "]")
+                {
+                    uniform.size = std::max(std::atoi(tokens[t + 2].c_str()), 1);
+                    uniform.name += "[0]";
+                    t += 3;
+                }
+                uniforms.push_back(uniform);
+            }
+        }
+        return uniforms;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace eng
+{
+    // What the engine asked the null backend to do since the last reset
+    struct NullGraphicsStats
+    {
+        size_t buffersCreated = 0;
+        size_t bufferUploads = 0;
+        size_t bufferBytes = 0;
+        size_t texturesCreated = 0;
+        size_t textureBytes = 0;
+        size_t shadersCreated = 0;
+        size_t programsCreated = 0;
+        size_t programBinds = 0;
+        size_t textureBinds = 0;
+        size_t uniformUploads = 0;
+        size_t drawCalls = 0;
+        size_t instancesDrawn = 0;
+        size_t verticesDrawn = 0;
+    };
+
+    // Points the GL functions the engine uses at stubs that count the calls
+    // instead of reaching a driver, so everything above the GraphicsAPI runs
+    // without a GPU or a context. Objects get fresh ids, compiles and links
+    // always succeed. A linked program reports the uniforms declared in its
+    // sources as active, so uniform lookups and uploads do the same work as
+    // on a driver. Only called from the thread that draws.
+    class NullGraphicsBackend
+    {
+    public:
+        static void Install();
+        static const NullGraphicsStats& GetStats();
+        static void ResetStats();
+        // Bytes of the last glBufferData call, to check what was uploaded
+        static const std::vector<unsigned char>& GetLastBufferData();
+
+    private:
+        struct Uniform
+        {
+            std::string name;
+            GLint location = -1;
+            GLint size = 1;
+            GLenum type = GL_FLOAT;
+        };
+
+        static void APIENTRY GenBuffers(GLsizei n, GLuint* buffers);
+        static void APIENTRY GenVertexArrays(GLsizei n, GLuint* arrays);
+        static void APIENTRY GenTextures(GLsizei n, GLuint* textures);
+        static void APIENTRY BufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage);
+        static void APIENTRY BufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data);
+        static void APIENTRY TexImage2D(GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height,
+            GLint border, GLenum format, GLenum type, const void* pixels);
+        static GLuint APIENTRY CreateShader(GLenum type);
+        static GLuint APIENTRY CreateProgram();
+        static void APIENTRY ShaderSource(GLuint shader, GLsizei count, const GLchar* const* string, const GLint* length);
+        static void APIENTRY AttachShader(GLuint program, GLuint shader);
+        static void APIENTRY LinkProgram(GLuint program);
+        static void APIENTRY DeleteShader(GLuint shader);
+        static void APIENTRY DeleteProgram(GLuint program);
+        static void APIENTRY GetShaderiv(GLuint shader, GLenum pname, GLint* params);
+        static void APIENTRY GetProgramiv(GLuint program, GLenum pname, GLint* params);
+        static void APIENTRY GetInfoLog(GLuint object, GLsizei bufSize, GLsizei* length, GLchar* infoLog);
+        static GLint APIENTRY GetUniformLocation(GLuint program, const GLchar* name);
+        static GLuint APIENTRY GetUniformBlockIndex(GLuint program, const GLchar* name);
+        static void APIENTRY GetActiveUniform(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size,
+            GLenum* type, GLchar* name);
+        static void APIENTRY UseProgram(GLuint program);
+        static void APIENTRY BindTexture(GLenum target, GLuint texture);
+        static void APIENTRY Uniform1i(GLint location, GLint v0);
+        static void APIENTRY Uniform1f(GLint location, GLfloat v0);
+        static void APIENTRY Uniform2f(GLint location, GLfloat v0, GLfloat v1);
+        static void APIENTRY UniformVector(GLint location, GLsizei count, const GLfloat* value);
+        static void APIENTRY UniformMatrix(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
+        static void APIENTRY DrawArrays(GLenum mode, GLint first, GLsizei count);
+        static void APIENTRY DrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices);
+        static void APIENTRY DrawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instanceCount);
+        static void APIENTRY DrawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void* indices,
+            GLsizei instanceCount);
+
+        // State changes and calls with nothing to record
+        static void APIENTRY IgnoreEnum(GLenum value);
+        static void APIENTRY IgnoreId(GLuint id);
+        static void APIENTRY IgnorePair(GLuint a, GLuint b);
+        static void APIENTRY IgnoreTriple(GLuint a, GLuint b, GLuint c);
+        static void APIENTRY IgnoreTexParameter(GLenum target, GLenum pname, GLint param);
+        static void APIENTRY IgnoreVertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized,
+            GLsizei stride, const void* pointer);
+        static void APIENTRY IgnoreViewport(GLint x, GLint y, GLsizei width, GLsizei height);
+        static void APIENTRY IgnoreDelete(GLsizei n, const GLuint* ids);
+        static void APIENTRY IgnoreColor(GLfloat r, GLfloat g, GLfloat b, GLfloat a);
+
+        // Declared uniforms in order, block members left out
+        static std::vector<Uniform> ParseUniforms(const std::string& source);
+
+        static NullGraphicsStats s_stats;
+        static GLuint s_nextId;
+        static std::vector<unsigned char> s_lastBufferData;
+        static std::unordered_map<GLuint, std::string> s_shaderSources;
+        static std::unordered_map<GLuint, std::vector<GLuint>> s_attachedShaders;
+        static std::unordered_map<GLuint, std::vector<Uniform>> s_programUniforms;
+    };
+}
\ No newline at end of file
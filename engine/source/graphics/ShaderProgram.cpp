@@ -1,16 +1,22 @@
 #include "graphics/ShaderProgram.h"
 #include "graphics/Texture.h"
+#include "Engine.h"
 #include <glm/gtc/type_ptr.hpp>
 
+#include <algorithm>
+#include <iostream>
+
 namespace eng
 {
     ShaderProgram::ShaderProgram(GLuint shaderProgramID) : m_shaderProgramID(shaderProgramID)
     {
+        Engine::GetInstance().CheckGraphicsThread("ShaderProgram");
+        ResolveUniforms();
     }
 
     ShaderProgram::~ShaderProgram()
     {
-        glDeleteProgram(m_shaderProgramID);
+        Engine::GetInstance().GetGraphicsAPI().DeleteShaderProgram(m_shaderProgramID);
     }
 
     void ShaderProgram::Bind()
@@ -19,57 +25,148 @@ namespace eng
         m_currentTextureUnit = 0;
     }
 
-    GLint ShaderProgram::GetUniformLocation(const std::string& name)
+    void ShaderProgram::ResetTextureUnits()
+    {
+        m_currentTextureUnit = 0;
+    }
+
+    GLuint ShaderProgram::GetSortId() const
+    {
+        return m_shaderProgramID;
+    }
+
+    ShaderProgram* ShaderProgram::GetInstancedVariant()
+    {
+        return m_instancedVariant.get();
+    }
+
+    void ShaderProgram::SetInstancedVariant(const std::shared_ptr<ShaderProgram>& variant)
+    {
+        m_instancedVariant = variant;
+    }
+
+    void ShaderProgram::ResolveUniforms()
+    {
+        GLint uniformCount = 0;
+        glGetProgramiv(m_shaderProgramID, GL_ACTIVE_UNIFORMS, &uniformCount);
+
+        GLint maxNameLength = 0;
+        glGetProgramiv(m_shaderProgramID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+        std::vector<GLchar> name(static_cast<size_t>(std::max(maxNameLength, 1)));
+
+        // Names with the same FNV-1a hash are told apart by the check hash.
+        // Should both hashes clash the names would share a location, so the
+        // first one wins and the clash is reported so one can be renamed.
+        std::vector<std::string> names;
+        auto addLocation = [this, &names](const std::string& uniformName, GLint location)
+        {
+            const UniformId id(uniformName);
+            for (size_t i = 0; i < m_uniformLocations.size(); ++i)
+            {
+                if (m_uniformLocations[i].hash == id.GetHash() && m_uniformLocations[i].checkHash == id.GetCheckHash())
+                {
+                    std::cerr << "ERROR:UNIFORM_HASH_COLLISION: " << uniformName << " and " << names[i]
+                        << " have the same hash " << id.GetHash() << std::endl;
+                    return;
+                }
+            }
+            m_uniformLocations.push_back({ id.GetHash(), id.GetCheckHash(), location });
+            names.push_back(uniformName);
+        };
+
+        for (GLint i = 0; i < uniformCount; ++i)
+        {
+            GLsizei length = 0;
+            GLint size = 0;
+            GLenum type = 0;
+            glGetActiveUniform(m_shaderProgramID, static_cast<GLuint>(i), static_cast<GLsizei>(name.size()),
+                &length, &size, &type, name.data());
+            std::string uniformName(name.data(), static_cast<size_t>(length));
+
+            // Uniform block members have no location
+            const GLint location = glGetUniformLocation(m_shaderProgramID, uniformName.c_str());
+            if (location < 0)
+            {
+                continue;
+            }
+
+            addLocation(uniformName, location);
+
+            // Arrays are reported as name[0], also reachable by the bare name.
+            // The other elements are not reported, nor are their locations
+            // guaranteed to follow the first one, so each is looked up.
+            const std::string arraySuffix = "[0]";
+            if (uniformName.size() > arraySuffix.size() &&
+                uniformName.compare(uniformName.size() - arraySuffix.size(), arraySuffix.size(), arraySuffix) == 0)
+            {
+                uniformName.resize(uniformName.size() - arraySuffix.size());
+                addLocation(uniformName, location);
+
+                for (GLint element = 1; element < size; ++element)
+                {
+                    const std::string elementName = uniformName + "[" + std::to_string(element) + "]";
+                    const GLint elementLocation = glGetUniformLocation(m_shaderProgramID, elementName.c_str());
+                    if (elementLocation >= 0)
+                    {
+                        addLocation(elementName, elementLocation);
+                    }
+                }
+            }
+        }
+    }
+
+    GLint ShaderProgram::GetUniformLocation(UniformId id) const
     {
-        auto it = m_uniformLocationCache.find(name);
-        if (it != m_uniformLocationCache.end())
+        const uint32_t hash = id.GetHash();
+        for (const auto& uniform : m_uniformLocations)
         {
-            return it->second;
+            if (uniform.hash == hash && uniform.checkHash == id.GetCheckHash())
+            {
+                return uniform.location;
+            }
         }
-        GLint location = glGetUniformLocation(m_shaderProgramID, name.c_str());
-        m_uniformLocationCache[name] = location;
-        return location;
+        return -1;
     }
 
-    void ShaderProgram::SetUniform(const std::string& name, int value)
+    void ShaderProgram::SetUniform(UniformId id, int value)
     {
-        auto location = GetUniformLocation(name);
+        auto location = GetUniformLocation(id);
         glUniform1i(location, value);
     }
 
-    void ShaderProgram::SetUniform(const std::string& name, float value)
+    void ShaderProgram::SetUniform(UniformId id, float value)
     {
-        auto location = GetUniformLocation(name);
+        auto location = GetUniformLocation(id);
         glUniform1f(location, value);
     }
 
-    void ShaderProgram::SetUniform(const std::string& name, float v0, float v1)
+    void ShaderProgram::SetUniform(UniformId id, float v0, float v1)
     {
-        auto location = GetUniformLocation(name);
+        auto location = GetUniformLocation(id);
         glUniform2f(location, v0, v1);
     }
 
-    void ShaderProgram::SetUniform(const std::string& name, const glm::mat4& mat)
+    void ShaderProgram::SetUniform(UniformId id, const glm::mat4& mat)
     {
-        auto location = GetUniformLocation(name);
+        auto location = GetUniformLocation(id);
         glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(mat));
     }
 
-    void ShaderProgram::SetUniform(const std::string& name, const glm::vec3& value)
+    void ShaderProgram::SetUniform(UniformId id, const glm::vec3& value)
     {
-        auto location = GetUniformLocation(name);
+        auto location = GetUniformLocation(id);
         glUniform3fv(location, 1, glm::value_ptr(value));
     }
 
-    void ShaderProgram::SetUniform(const std::string& name, const glm::vec4& value)
+    void ShaderProgram::SetUniform(UniformId id, const glm::vec4& value)
     {
-        auto location = GetUniformLocation(name);
+        auto location = GetUniformLocation(id);
         glUniform4fv(location, 1, glm::value_ptr(value));
     }
 
-    void ShaderProgram::SetTexture(const std::string& name, Texture* texture)
+    void ShaderProgram::SetTexture(UniformId id, Texture* texture)
     {
-        auto location = GetUniformLocation(name);
+        auto location = GetUniformLocation(id);
 
         glActiveTexture(GL_TEXTURE0 + m_currentTextureUnit);
         glBindTexture(GL_TEXTURE_2D, texture->GetID());
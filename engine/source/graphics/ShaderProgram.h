@@ -1,6 +1,8 @@
 #pragma once
+#include <cstdint>
+#include <memory>
 #include <string>
-#include <unordered_map>
+#include <vector>
 #include <glad/glad.h>
 #include <glm/mat4x4.hpp>
 
@@ -8,6 +10,58 @@ namespace eng
 {
     class Texture;
 
+    // Uniform name as an FNV-1a hash. Built from a literal in a constexpr
+    // context it is hashed at compile time, so setting a uniform neither
+    // builds nor hashes a std::string. A second, djb2 hash tells apart
+    // names whose FNV-1a hashes collide.
+    class UniformId
+    {
+    public:
+        constexpr UniformId(const char* name)
+            : m_hash(Hash(name)), m_checkHash(CheckHash(name))
+        {
+        }
+
+        UniformId(const std::string& name)
+            : m_hash(Hash(name.c_str())), m_checkHash(CheckHash(name.c_str()))
+        {
+        }
+
+        constexpr uint32_t GetHash() const
+        {
+            return m_hash;
+        }
+
+        constexpr uint32_t GetCheckHash() const
+        {
+            return m_checkHash;
+        }
+
+        static constexpr uint32_t Hash(const char* name)
+        {
+            uint32_t hash = 2166136261u;
+            for (; *name; ++name)
+            {
+                hash = (hash ^ static_cast<uint8_t>(*name)) * 16777619u;
+            }
+            return hash;
+        }
+
+        static constexpr uint32_t CheckHash(const char* name)
+        {
+            uint32_t hash = 5381u;
+            for (; *name; ++name)
+            {
+                hash = hash * 33u + static_cast<uint8_t>(*name);
+            }
+            return hash;
+        }
+
+    private:
+        uint32_t m_hash;
+        uint32_t m_checkHash;
+    };
+
     class ShaderProgram
     {
     public:
@@ -18,17 +72,43 @@ namespace eng
         ~ShaderProgram();
 
         void Bind();
-        GLint GetUniformLocation(const std::string& name);
-        void SetUniform(const std::string& name, int value);
-        void SetUniform(const std::string& name, float value);
-        void SetUniform(const std::string& name, float v0, float v1);
-        void SetUniform(const std::string& name, const glm::mat4& mat);
-        void SetUniform(const std::string& name, const glm::vec3& value);
-        void SetUniform(const std::string& name, const glm::vec4& value);
-        void SetTexture(const std::string& name, Texture* texture);
+        // Texture params start again at unit 0, done by Bind as well
+        void ResetTextureUnits();
+        // The GL program name, unique while the program lives
+        GLuint GetSortId() const;
+
+        // Same shaders compiled with INSTANCED defined, which take the model
+        // matrix as a per instance attribute. Null if the shader has no
+        // instanced path.
+        ShaderProgram* GetInstancedVariant();
+        void SetInstancedVariant(const std::shared_ptr<ShaderProgram>& variant);
+
+        // -1 for names that are not an active uniform of the program, which
+        // GL ignores when setting
+        GLint GetUniformLocation(UniformId id) const;
+        void SetUniform(UniformId id, int value);
+        void SetUniform(UniformId id, float value);
+        void SetUniform(UniformId id, float v0, float v1);
+        void SetUniform(UniformId id, const glm::mat4& mat);
+        void SetUniform(UniformId id, const glm::vec3& value);
+        void SetUniform(UniformId id, const glm::vec4& value);
+        void SetTexture(UniformId id, Texture* texture);
+
+    private:
+        // Reads the active uniforms once after linking
+        void ResolveUniforms();
 
     private:
-        std::unordered_map<std::string, GLint> m_uniformLocationCache;
+        struct UniformLocation
+        {
+            uint32_t hash;
+            uint32_t checkHash;
+            GLint location;
+        };
+
+        // A program has few uniforms, a linear scan beats a hash map
+        std::vector<UniformLocation> m_uniformLocations;
+        std::shared_ptr<ShaderProgram> m_instancedVariant;
         GLuint m_shaderProgramID = 0;
         int m_currentTextureUnit = 0;
     };
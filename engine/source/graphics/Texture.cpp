@@ -9,6 +9,7 @@ namespace eng
     Texture::Texture(int width, int height, int numChannels, unsigned char* data)
         : m_width(width), m_height(height), m_numChannels(numChannels)
     {
+        Engine::GetInstance().CheckGraphicsThread("Texture");
         Init(width, height, numChannels, data);
     }
 
@@ -16,7 +17,7 @@ namespace eng
     {
         if (m_textureID > 0)
         {
-            glDeleteTextures(1, &m_textureID);
+            Engine::GetInstance().GetGraphicsAPI().DeleteTexture(m_textureID);
         }
     }
 
@@ -16,6 +16,8 @@ namespace eng
         static constexpr int ColorIndex = 1;
         static constexpr int UVIndex = 2;
         static constexpr int NormalIndex = 3;
+        // Per instance model matrix of instanced shaders, four locations
+        static constexpr int InstanceModelIndex = 4;
     };
 
     struct VertexLayout
@@ -0,0 +1,92 @@
+#include "input/SyntheticInput.h"
+#include "input/InputManager.h"
+
+#include <algorithm>
+
+namespace eng
+{
+    void SyntheticInput::AddKey(uint64_t frame, int key, bool pressed)
+    {
+        Event event;
+        event.frame = frame;
+        event.type = EventType::Key;
+        event.code = key;
+        event.pressed = pressed;
+        AddEvent(event);
+    }
+
+    void SyntheticInput::AddMouseButton(uint64_t frame, int button, bool pressed)
+    {
+        Event event;
+        event.frame = frame;
+        event.type = EventType::MouseButton;
+        event.code = button;
+        event.pressed = pressed;
+        AddEvent(event);
+    }
+
+    void SyntheticInput::AddMouseMove(uint64_t frame, const glm::vec2& position)
+    {
+        Event event;
+        event.frame = frame;
+        event.type = EventType::MouseMove;
+        event.position = position;
+        AddEvent(event);
+    }
+
+    void SyntheticInput::Clear()
+    {
+        m_events.clear();
+        m_nextEvent = 0;
+    }
+
+    bool SyntheticInput::IsEmpty() const
+    {
+        return m_events.empty();
+    }
+
+    void SyntheticInput::Apply(InputManager& inputManager, uint64_t frame)
+    {
+        // Events of skipped frames are applied late rather than lost
+        while (m_nextEvent < m_events.size() && m_events[m_nextEvent].frame <= frame)
+        {
+            const auto& event = m_events[m_nextEvent++];
+            switch (event.type)
+            {
+            case EventType::Key:
+            {
+                inputManager.SetKeyPressed(event.code, event.pressed);
+            }
+            break;
+            case EventType::MouseButton:
+            {
+                inputManager.SetMouseButtonPressed(event.code, event.pressed);
+                if (event.pressed)
+                {
+                    inputManager.SetMouseButtonWasPressed(event.code, true);
+                }
+                else
+                {
+                    inputManager.SetMouseButtonWasReleased(event.code, true);
+                }
+            }
+            break;
+            case EventType::MouseMove:
+            {
+                inputManager.SetMousePositionOld(inputManager.GetMousePositionCurrent());
+                inputManager.SetMousePositionCurrent(event.position);
+                inputManager.SetMousePositionChanged(true);
+            }
+            break;
+            }
+        }
+    }
+
+    void SyntheticInput::AddEvent(const Event& event)
+    {
+        // Kept sorted by frame, events of the same frame stay in order
+        auto it = std::upper_bound(m_events.begin() + m_nextEvent, m_events.end(), event.frame,
+            [](uint64_t frame, const Event& other) { return frame < other.frame; });
+        m_events.insert(it, event);
+    }
+}
\ No newline at end of file
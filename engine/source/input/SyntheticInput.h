@@ -0,0 +1,50 @@
+#pragma once
+
+#include <glm/vec2.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace eng
+{
+    class InputManager;
+
+    // Scripted input for runs without a window. Events are fed to the
+    // InputManager at the start of the frame they are scheduled for, the
+    // same way the window callbacks would, so a replay is deterministic.
+    class SyntheticInput
+    {
+    public:
+        void AddKey(uint64_t frame, int key, bool pressed);
+        void AddMouseButton(uint64_t frame, int button, bool pressed);
+        void AddMouseMove(uint64_t frame, const glm::vec2& position);
+        void Clear();
+        bool IsEmpty() const;
+
+        // Applies the events of the frame, frames have to come in order
+        void Apply(InputManager& inputManager, uint64_t frame);
+
+    private:
+        enum class EventType
+        {
+            Key,
+            MouseButton,
+            MouseMove
+        };
+
+        struct Event
+        {
+            uint64_t frame = 0;
+            EventType type = EventType::Key;
+            int code = 0;
+            bool pressed = false;
+            glm::vec2 position = glm::vec2(0.0f);
+        };
+
+        void AddEvent(const Event& event);
+
+    private:
+        std::vector<Event> m_events;
+        size_t m_nextEvent = 0;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,185 @@
+#include "jobs/JobSystem.h"
+
+#include <algorithm>
+
+namespace eng
+{
+    static thread_local size_t s_threadIndex = 0;
+
+    JobSystem::~JobSystem()
+    {
+        Shutdown();
+    }
+
+    void JobSystem::Init(size_t workerCount)
+    {
+        Shutdown();
+
+        m_queues.clear();
+        for (size_t i = 0; i < workerCount + 1; ++i)
+        {
+            m_queues.push_back(std::make_unique<WorkQueue>());
+        }
+
+        m_running = true;
+        for (size_t i = 1; i <= workerCount; ++i)
+        {
+            m_workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+        }
+    }
+
+    void JobSystem::Shutdown()
+    {
+        if (!m_running)
+        {
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_wakeMutex);
+            m_running = false;
+        }
+        m_wakeCondition.notify_all();
+
+        for (auto& worker : m_workers)
+        {
+            worker.join();
+        }
+        m_workers.clear();
+    }
+
+    size_t JobSystem::GetThreadCount() const
+    {
+        return m_workers.size() + 1;
+    }
+
+    size_t JobSystem::GetThreadIndex()
+    {
+        return s_threadIndex;
+    }
+
+    void JobSystem::Submit(Job job, JobCounter& counter)
+    {
+        counter.fetch_add(1);
+
+        // Without workers the job runs right away
+        if (m_workers.empty())
+        {
+            job();
+            counter.fetch_sub(1);
+            return;
+        }
+
+        // Counted before the push, so a thief never takes the count below zero
+        {
+            std::lock_guard<std::mutex> lock(m_wakeMutex);
+            m_pendingJobs.fetch_add(1);
+        }
+
+        auto& queue = *m_queues[s_threadIndex < m_queues.size() ? s_threadIndex : 0];
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.jobs.emplace_back(std::move(job), &counter);
+        }
+        m_wakeCondition.notify_one();
+    }
+
+    void JobSystem::Wait(JobCounter& counter)
+    {
+        while (counter.load() > 0)
+        {
+            if (!RunNextJob(s_threadIndex < m_queues.size() ? s_threadIndex : 0))
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void JobSystem::ParallelFor(size_t count, const std::function<void(size_t)>& func)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+
+        // One job per thread, each pulls indices from a shared cursor so
+        // uneven items balance out
+        std::atomic<size_t> next = 0;
+        auto body = [&next, count, &func]()
+            {
+                for (size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1))
+                {
+                    func(i);
+                }
+            };
+
+        JobCounter counter = 0;
+        const size_t jobCount = std::min(count, GetThreadCount());
+        for (size_t i = 1; i < jobCount; ++i)
+        {
+            Submit(body, counter);
+        }
+        body();
+        Wait(counter);
+    }
+
+    void JobSystem::WorkerLoop(size_t threadIndex)
+    {
+        s_threadIndex = threadIndex;
+
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(m_wakeMutex);
+                m_wakeCondition.wait(lock, [this]() { return !m_running || m_pendingJobs.load() > 0; });
+                if (!m_running)
+                {
+                    return;
+                }
+            }
+
+            RunNextJob(threadIndex);
+        }
+    }
+
+    bool JobSystem::RunNextJob(size_t threadIndex)
+    {
+        std::pair<Job, JobCounter*> entry;
+        bool found = false;
+
+        // Own queue first, newest job
+        {
+            auto& queue = *m_queues[threadIndex];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.jobs.empty())
+            {
+                entry = std::move(queue.jobs.back());
+                queue.jobs.pop_back();
+                found = true;
+            }
+        }
+
+        // Then steal the oldest job of another thread
+        for (size_t i = 1; !found && i < m_queues.size(); ++i)
+        {
+            auto& queue = *m_queues[(threadIndex + i) % m_queues.size()];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.jobs.empty())
+            {
+                entry = std::move(queue.jobs.front());
+                queue.jobs.pop_front();
+                found = true;
+            }
+        }
+
+        if (!found)
+        {
+            return false;
+        }
+
+        m_pendingJobs.fetch_sub(1);
+        entry.first();
+        entry.second->fetch_sub(1);
+        return true;
+    }
+}
\ No newline at end of file
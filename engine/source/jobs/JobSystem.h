@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace eng
+{
+    using Job = std::function<void()>;
+    // Number of unfinished jobs of a batch, see JobSystem::Wait
+    using JobCounter = std::atomic<size_t>;
+
+    // Fixed pool of worker threads. Every thread owns a queue and takes its
+    // own jobs from the back, idle threads steal from the front of the
+    // other queues. The thread that waits for a batch runs jobs as well.
+    class JobSystem
+    {
+    public:
+        JobSystem() = default;
+        ~JobSystem();
+        JobSystem(const JobSystem&) = delete;
+        JobSystem& operator=(const JobSystem&) = delete;
+
+        void Init(size_t workerCount);
+        void Shutdown();
+
+        // Worker threads plus the main thread
+        size_t GetThreadCount() const;
+        // 0 on the main thread and any thread not owned by the job system
+        static size_t GetThreadIndex();
+
+        void Submit(Job job, JobCounter& counter);
+        void Wait(JobCounter& counter);
+
+        // Calls func(i) for every i in [0, count) and returns when all are done
+        void ParallelFor(size_t count, const std::function<void(size_t)>& func);
+
+    private:
+        struct WorkQueue
+        {
+            std::mutex mutex;
+            std::deque<std::pair<Job, JobCounter*>> jobs;
+        };
+
+        void WorkerLoop(size_t threadIndex);
+        bool RunNextJob(size_t threadIndex);
+
+    private:
+        std::vector<std::thread> m_workers;
+        std::vector<std::unique_ptr<WorkQueue>> m_queues;
+        std::mutex m_wakeMutex;
+        std::condition_variable m_wakeCondition;
+        std::atomic<size_t> m_pendingJobs = 0;
+        std::atomic<bool> m_running = false;
+    };
+}
\ No newline at end of file
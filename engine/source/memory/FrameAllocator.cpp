@@ -0,0 +1,137 @@
+#include "memory/FrameAllocator.h"
+#include "jobs/JobSystem.h"
+#include "Engine.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace eng
+{
+    FrameArena::FrameArena(size_t blockSize)
+        : m_blockSize(blockSize)
+    {
+    }
+
+    void* FrameArena::Allocate(size_t size, size_t alignment)
+    {
+        if (!m_blocks.empty())
+        {
+            auto& block = m_blocks.back();
+            const uintptr_t base = reinterpret_cast<uintptr_t>(block.memory.get());
+            const size_t offset = ((base + m_offset + alignment - 1) & ~(alignment - 1)) - base;
+            if (offset + size <= block.size)
+            {
+                m_offset = offset + size;
+                return block.memory.get() + offset;
+            }
+        }
+
+        // A new block is aligned for any fundamental type
+        AddBlock(size);
+        m_offset = size;
+        return m_blocks.back().memory.get();
+    }
+
+    void FrameArena::Reset()
+    {
+        // Blocks added during the frame are merged into one, so the next
+        // frame of the same size fits without touching the heap
+        if (m_blocks.size() > 1)
+        {
+            const size_t capacity = GetCapacity();
+            m_blocks.clear();
+            AddBlock(capacity);
+        }
+
+        m_offset = 0;
+        m_previousBlocksUsed = 0;
+        m_heapAllocations = 0;
+    }
+
+    size_t FrameArena::GetUsed() const
+    {
+        return m_previousBlocksUsed + m_offset;
+    }
+
+    size_t FrameArena::GetCapacity() const
+    {
+        size_t capacity = 0;
+        for (auto& block : m_blocks)
+        {
+            capacity += block.size;
+        }
+        return capacity;
+    }
+
+    size_t FrameArena::GetHeapAllocations() const
+    {
+        return m_heapAllocations;
+    }
+
+    void FrameArena::AddBlock(size_t minSize)
+    {
+        m_previousBlocksUsed += m_offset;
+        m_offset = 0;
+
+        Block block;
+        block.size = std::max(m_blockSize, minSize);
+        block.memory.reset(new char[block.size]);
+        m_blocks.push_back(std::move(block));
+        ++m_heapAllocations;
+    }
+
+    FrameAllocator::FrameAllocator()
+    {
+        // Enough for the main thread until Init knows the thread count
+        for (auto& arenas : m_arenas)
+        {
+            arenas.resize(1);
+        }
+    }
+
+    void FrameAllocator::Init()
+    {
+        const size_t threadCount = Engine::GetInstance().GetJobSystem().GetThreadCount();
+        for (auto& arenas : m_arenas)
+        {
+            arenas.resize(threadCount);
+        }
+    }
+
+    FrameArena& FrameAllocator::GetArena()
+    {
+        auto& arenas = m_arenas[m_current];
+        const size_t index = JobSystem::GetThreadIndex();
+        return arenas[index < arenas.size() ? index : 0];
+    }
+
+    FrameArena& FrameAllocator::GetCurrentArena()
+    {
+        return Engine::GetInstance().GetFrameAllocator().GetArena();
+    }
+
+    void* FrameAllocator::Allocate(size_t size, size_t alignment)
+    {
+        return GetArena().Allocate(size, alignment);
+    }
+
+    void FrameAllocator::EndFrame()
+    {
+        m_lastFrameHeapAllocations = 0;
+        for (auto& arena : m_arenas[m_current])
+        {
+            m_lastFrameHeapAllocations += arena.GetHeapAllocations();
+        }
+
+        m_current = 1 - m_current;
+        for (auto& arena : m_arenas[m_current])
+        {
+            arena.Reset();
+        }
+    }
+
+    size_t FrameAllocator::GetLastFrameHeapAllocations() const
+    {
+        return m_lastFrameHeapAllocations;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace eng
+{
+    // Bump allocator. Individual allocations are never freed, Reset drops
+    // everything at once and keeps the memory for the next use.
+    class FrameArena
+    {
+    public:
+        explicit FrameArena(size_t blockSize = 64 * 1024);
+        FrameArena(const FrameArena&) = delete;
+        FrameArena& operator=(const FrameArena&) = delete;
+        FrameArena(FrameArena&&) = default;
+        FrameArena& operator=(FrameArena&&) = default;
+
+        void* Allocate(size_t size, size_t alignment);
+        void Reset();
+
+        size_t GetUsed() const;
+        size_t GetCapacity() const;
+        // Blocks taken from the heap since the last Reset
+        size_t GetHeapAllocations() const;
+
+    private:
+        struct Block
+        {
+            std::unique_ptr<char[]> memory;
+            size_t size = 0;
+        };
+
+        void AddBlock(size_t minSize);
+
+        std::vector<Block> m_blocks;
+        size_t m_blockSize = 0;
+        size_t m_offset = 0;
+        // Used bytes of the blocks before the last one
+        size_t m_previousBlocksUsed = 0;
+        size_t m_heapAllocations = 0;
+    };
+
+    // Memory for data that lives for one frame, one arena per job system
+    // thread so allocating needs no locks. There are two sets of arenas:
+    // the frame built by an update is drawn while the next update already
+    // runs in pipelined mode, so its memory has to stay valid until the end
+    // of the following frame.
+    class FrameAllocator
+    {
+    public:
+        FrameAllocator();
+        void Init();
+
+        // Arena of the calling thread for the current frame
+        FrameArena& GetArena();
+        // Same for the frame allocator of the engine
+        static FrameArena& GetCurrentArena();
+        void* Allocate(size_t size, size_t alignment);
+
+        // Switches to the other set of arenas and resets it. Everything
+        // allocated in the frame before the one just ended is gone.
+        void EndFrame();
+
+        // Heap allocations of the arenas in the frame that just ended
+        size_t GetLastFrameHeapAllocations() const;
+
+    private:
+        std::array<std::vector<FrameArena>, 2> m_arenas;
+        size_t m_current = 0;
+        size_t m_lastFrameHeapAllocations = 0;
+    };
+
+    // STL allocator over the frame arena of the thread that first
+    // allocates through it. Deallocation does nothing, the memory returns with the
+    // arena reset.
+    template<typename T>
+    class FrameStlAllocator
+    {
+    public:
+        using value_type = T;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
+
+        FrameStlAllocator() = default;
+
+        template<typename U>
+        FrameStlAllocator(const FrameStlAllocator<U>& other)
+            : m_arena(other.GetArena())
+        {
+        }
+
+        T* allocate(size_t count)
+        {
+            // Bound on first use, so containers can be declared anywhere,
+            // including members of the engine itself
+            if (!m_arena)
+            {
+                m_arena = &FrameAllocator::GetCurrentArena();
+            }
+            return static_cast<T*>(m_arena->Allocate(count * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T*, size_t)
+        {
+        }
+
+        // Copies allocate from the arena of the copying thread
+        FrameStlAllocator select_on_container_copy_construction() const
+        {
+            return FrameStlAllocator();
+        }
+
+        FrameArena* GetArena() const
+        {
+            return m_arena;
+        }
+
+        template<typename U>
+        bool operator==(const FrameStlAllocator<U>& other) const
+        {
+            return m_arena == other.GetArena();
+        }
+
+        template<typename U>
+        bool operator!=(const FrameStlAllocator<U>& other) const
+        {
+            return m_arena != other.GetArena();
+        }
+
+    private:
+        FrameArena* m_arena = nullptr;
+    };
+
+    template<typename T>
+    using FrameVector = std::vector<T, FrameStlAllocator<T>>;
+}
\ No newline at end of file
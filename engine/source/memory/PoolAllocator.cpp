@@ -0,0 +1,162 @@
+#include "memory/PoolAllocator.h"
+
+#include <new>
+
+namespace eng
+{
+    PoolAllocator::PoolAllocator(size_t blockSize, size_t blocksPerChunk)
+        : m_blockSize(blockSize < sizeof(FreeBlock) ? sizeof(FreeBlock) : blockSize),
+        m_blocksPerChunk(blocksPerChunk)
+    {
+    }
+
+    PoolAllocator::~PoolAllocator()
+    {
+        for (auto chunk : m_chunks)
+        {
+            ::operator delete(chunk);
+        }
+    }
+
+    void* PoolAllocator::Allocate()
+    {
+        if (!m_freeList)
+        {
+            AddChunk();
+        }
+
+        FreeBlock* block = m_freeList;
+        m_freeList = block->next;
+        return block;
+    }
+
+    void PoolAllocator::Deallocate(void* ptr)
+    {
+        auto block = static_cast<FreeBlock*>(ptr);
+        block->next = m_freeList;
+        m_freeList = block;
+    }
+
+    size_t PoolAllocator::GetBlockSize() const
+    {
+        return m_blockSize;
+    }
+
+    size_t PoolAllocator::GetChunkCount() const
+    {
+        return m_chunks.size();
+    }
+
+    void PoolAllocator::AddChunk()
+    {
+        auto chunk = static_cast<char*>(::operator new(m_blockSize * m_blocksPerChunk));
+        m_chunks.push_back(chunk);
+
+        // Thread the new blocks so the lowest address is handed out first
+        for (size_t i = m_blocksPerChunk; i > 0; --i)
+        {
+            auto block = reinterpret_cast<FreeBlock*>(chunk + (i - 1) * m_blockSize);
+            block->next = m_freeList;
+            m_freeList = block;
+        }
+    }
+
+    ObjectPools::ObjectPools()
+    {
+        // Created up front, so finding a small pool takes no lock. Pools
+        // take no memory until their first allocation.
+        for (size_t sizeClass = 0; sizeClass < SmallSizeClasses; ++sizeClass)
+        {
+            m_smallPools[sizeClass] = std::make_unique<SizeClass>(sizeClass * SizeClassGranularity);
+        }
+    }
+
+    void* ObjectPools::Allocate(size_t size)
+    {
+        auto& instance = GetInstance();
+        instance.m_currentFrame.allocations.fetch_add(1, std::memory_order_relaxed);
+        instance.m_total.allocations.fetch_add(1, std::memory_order_relaxed);
+
+        auto& sizeClass = instance.GetPool(GetSizeClass(size));
+        std::lock_guard<std::mutex> lock(sizeClass.mutex);
+        const size_t chunks = sizeClass.pool.GetChunkCount();
+        void* ptr = sizeClass.pool.Allocate();
+        if (sizeClass.pool.GetChunkCount() != chunks)
+        {
+            instance.m_currentFrame.heapAllocations.fetch_add(1, std::memory_order_relaxed);
+            instance.m_total.heapAllocations.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        return ptr;
+    }
+
+    void ObjectPools::Deallocate(void* ptr, size_t size)
+    {
+        if (!ptr)
+        {
+            return;
+        }
+
+        auto& instance = GetInstance();
+        instance.m_currentFrame.deallocations.fetch_add(1, std::memory_order_relaxed);
+        instance.m_total.deallocations.fetch_add(1, std::memory_order_relaxed);
+
+        auto& sizeClass = instance.GetPool(GetSizeClass(size));
+        std::lock_guard<std::mutex> lock(sizeClass.mutex);
+        sizeClass.pool.Deallocate(ptr);
+    }
+
+    void ObjectPools::EndFrame()
+    {
+        auto& instance = GetInstance();
+        auto& frame = instance.m_currentFrame;
+        instance.m_lastFrame.allocations = frame.allocations.exchange(0, std::memory_order_relaxed);
+        instance.m_lastFrame.deallocations = frame.deallocations.exchange(0, std::memory_order_relaxed);
+        instance.m_lastFrame.heapAllocations = frame.heapAllocations.exchange(0, std::memory_order_relaxed);
+    }
+
+    const AllocationStats& ObjectPools::GetFrameStats()
+    {
+        return GetInstance().m_lastFrame;
+    }
+
+    AllocationStats ObjectPools::GetTotalStats()
+    {
+        auto& total = GetInstance().m_total;
+        AllocationStats stats;
+        stats.allocations = total.allocations.load(std::memory_order_relaxed);
+        stats.deallocations = total.deallocations.load(std::memory_order_relaxed);
+        stats.heapAllocations = total.heapAllocations.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    ObjectPools::SizeClass& ObjectPools::GetPool(size_t sizeClass)
+    {
+        if (sizeClass < SmallSizeClasses)
+        {
+            return *m_smallPools[sizeClass];
+        }
+
+        // The map only grows, a pool stays where it is once created
+        std::lock_guard<std::mutex> lock(m_largePoolsMutex);
+        auto& pool = m_largePools[sizeClass];
+        if (!pool)
+        {
+            pool = std::make_unique<SizeClass>(sizeClass * SizeClassGranularity);
+        }
+        return *pool;
+    }
+
+    size_t ObjectPools::GetSizeClass(size_t size)
+    {
+        return (size + SizeClassGranularity - 1) / SizeClassGranularity;
+    }
+
+    ObjectPools& ObjectPools::GetInstance()
+    {
+        // Never destroyed, objects owned by other statics may be released
+        // after the end of main
+        static ObjectPools* instance = new ObjectPools();
+        return *instance;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace eng
+{
+    // Fixed size block allocator. Memory is taken from the heap in chunks
+    // and released blocks go to a free list for reuse, so steady spawn and
+    // despawn never reaches malloc.
+    class PoolAllocator
+    {
+    public:
+        PoolAllocator(size_t blockSize, size_t blocksPerChunk = 64);
+        ~PoolAllocator();
+        PoolAllocator(const PoolAllocator&) = delete;
+        PoolAllocator& operator=(const PoolAllocator&) = delete;
+
+        void* Allocate();
+        void Deallocate(void* ptr);
+
+        size_t GetBlockSize() const;
+        size_t GetChunkCount() const;
+
+    private:
+        struct FreeBlock
+        {
+            FreeBlock* next;
+        };
+
+        void AddChunk();
+
+        size_t m_blockSize = 0;
+        size_t m_blocksPerChunk = 0;
+        std::vector<void*> m_chunks;
+        FreeBlock* m_freeList = nullptr;
+    };
+
+    struct AllocationStats
+    {
+        size_t allocations = 0;
+        size_t deallocations = 0;
+        // Requests that had to go to the heap: new chunks and oversized blocks
+        size_t heapAllocations = 0;
+    };
+
+    // Pools for GameObjects and Components, one per 16 byte size class.
+    // Used by the class level operator new and delete of both base classes,
+    // so every derived type gets pooled, whichever way it is created. Each
+    // size class has its own lock, so threads of the job system only wait
+    // for each other when they create or destroy objects of the same size.
+    class ObjectPools
+    {
+    public:
+        static void* Allocate(size_t size);
+        static void Deallocate(void* ptr, size_t size);
+
+        // Closes the frame, its counters become the last frame stats. Called
+        // on the main thread.
+        static void EndFrame();
+        static const AllocationStats& GetFrameStats();
+        static AllocationStats GetTotalStats();
+
+    private:
+        static constexpr size_t SizeClassGranularity = 16;
+        // Size classes up to this are in a fixed table, larger ones are
+        // looked up in a map, they are rare
+        static constexpr size_t SmallSizeLimit = 1024;
+        static constexpr size_t SmallSizeClasses = SmallSizeLimit / SizeClassGranularity + 1;
+
+        struct SizeClass
+        {
+            explicit SizeClass(size_t blockSize)
+                : pool(blockSize)
+            {
+            }
+
+            std::mutex mutex;
+            PoolAllocator pool;
+        };
+
+        struct Counters
+        {
+            std::atomic<size_t> allocations{ 0 };
+            std::atomic<size_t> deallocations{ 0 };
+            std::atomic<size_t> heapAllocations{ 0 };
+        };
+
+        ObjectPools();
+        static size_t GetSizeClass(size_t size);
+        static ObjectPools& GetInstance();
+        SizeClass& GetPool(size_t sizeClass);
+
+        std::array<std::unique_ptr<SizeClass>, SmallSizeClasses> m_smallPools;
+        std::mutex m_largePoolsMutex;
+        std::unordered_map<size_t, std::unique_ptr<SizeClass>> m_largePools;
+        Counters m_currentFrame;
+        Counters m_total;
+        AllocationStats m_lastFrame;
+    };
+}
\ No newline at end of file
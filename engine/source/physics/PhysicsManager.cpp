@@ -1,6 +1,7 @@
 #include "physics/PhysicsManager.h"
 #include "physics/RigidBody.h"
 #include "physics/CollisionObject.h"
+#include "profiling/Profiler.h"
 
 #include <btBulletCollisionCommon.h>
 #include <btBulletDynamicsCommon.h>
@@ -30,10 +31,25 @@ namespace eng
 
     void PhysicsManager::Update(float deltaTime)
     {
+        ENG_PROFILE_SCOPE("PhysicsManager::Update");
         const btScalar fixedTimeStep = 1.0f / 60.0f;
         const int maxSubsteps = 4;
         m_world->stepSimulation(deltaTime, maxSubsteps, fixedTimeStep);
 
+        ProcessCollisions();
+    }
+
+    void PhysicsManager::Step(float timeStep)
+    {
+        ENG_PROFILE_SCOPE("PhysicsManager::Step");
+        // No substeps, so Bullet neither accumulates nor interpolates
+        m_world->stepSimulation(timeStep, 0);
+
+        ProcessCollisions();
+    }
+
+    void PhysicsManager::ProcessCollisions()
+    {
         // process collisions
         auto dispatcher = m_world->getDispatcher();
         const auto numManifolds = dispatcher->getNumManifolds();
@@ -79,6 +95,7 @@ namespace eng
             return;
         }
 
+        std::lock_guard<std::mutex> lock(m_bodiesMutex);
         if (auto rigidBody = body->GetBody())
         {
             m_world->addRigidBody(rigidBody, btBroadphaseProxy::StaticFilter,
@@ -94,6 +111,7 @@ namespace eng
             return;
         }
 
+        std::lock_guard<std::mutex> lock(m_bodiesMutex);
         if (auto rigidBody = body->GetBody())
         {
             m_world->removeRigidBody(rigidBody);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 
 class btBroadphaseInterface;
 class btDefaultCollisionConfiguration;
@@ -20,17 +21,24 @@ namespace eng
 
         void Init();
         void Update(float deltaTime);
+        // Exactly one simulation step, for the fixed timestep mode of the engine
+        void Step(float timeStep);
 
         void AddRigidBody(RigidBody* body);
         void RemoveRigidBody(RigidBody* body);
 
         btDiscreteDynamicsWorld* GetWorld();
 
+    private:
+        void ProcessCollisions();
+
     private:
         std::unique_ptr<btBroadphaseInterface> m_broadphase;
         std::unique_ptr<btDefaultCollisionConfiguration> m_collisionConfig;
         std::unique_ptr<btCollisionDispatcher> m_dispatcher;
         std::unique_ptr<btSequentialImpulseConstraintSolver> m_solver;
         std::unique_ptr<btDiscreteDynamicsWorld> m_world;
+        // Bodies can be added or removed from parallel scene updates
+        std::mutex m_bodiesMutex;
     };
 }
\ No newline at end of file
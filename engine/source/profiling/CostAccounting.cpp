@@ -0,0 +1,197 @@
+#include "profiling/CostAccounting.h"
+#include "profiling/Profiler.h"
+#include "jobs/JobSystem.h"
+#include "scene/Component.h"
+#include "scene/GameObject.h"
+
+#include <algorithm>
+
+namespace eng
+{
+    // Time spent in finished scopes nested in the innermost open one
+    static thread_local uint64_t s_nestedNanos = 0;
+
+    void CostAccounting::Init(size_t threadCount)
+    {
+        m_threads.clear();
+        m_threads.resize(std::max<size_t>(threadCount, 1));
+    }
+
+    void CostAccounting::SetEnabled(bool enabled)
+    {
+        m_enabled = enabled;
+    }
+
+    bool CostAccounting::IsEnabled() const
+    {
+        return m_enabled;
+    }
+
+    bool CostAccounting::SetCsvOutput(const std::string& path, size_t intervalFrames)
+    {
+        m_csv.close();
+        m_csvInterval = 0;
+        m_intervalFrames = 0;
+        m_intervalComponents.clear();
+        m_intervalObjects.clear();
+        if (path.empty())
+        {
+            return true;
+        }
+
+        m_csv.open(path, std::ios::out | std::ios::trunc);
+        if (!m_csv)
+        {
+            return false;
+        }
+
+        m_csvInterval = std::max<size_t>(intervalFrames, 1);
+        m_csv << "frame,category,type,calls,total_ms,ms_per_frame\n";
+        return true;
+    }
+
+    void CostAccounting::EndFrame()
+    {
+        ++m_frame;
+        m_frameComponents.clear();
+        m_frameObjects.clear();
+        for (auto& thread : m_threads)
+        {
+            Collect(thread.components, m_frameComponents, m_intervalComponents);
+            Collect(thread.objects, m_frameObjects, m_intervalObjects);
+        }
+
+        BuildCosts(Category::Component, m_frameComponents, m_componentCosts);
+        BuildCosts(Category::Object, m_frameObjects, m_objectCosts);
+
+        if (m_csvInterval > 0 && ++m_intervalFrames >= m_csvInterval)
+        {
+            WriteCsv();
+        }
+    }
+
+    const std::vector<TypeCost>& CostAccounting::GetComponentCosts() const
+    {
+        return m_componentCosts;
+    }
+
+    const std::vector<TypeCost>& CostAccounting::GetObjectCosts() const
+    {
+        return m_objectCosts;
+    }
+
+    void CostAccounting::Add(Category category, size_t typeId, uint64_t nanos, uint64_t calls)
+    {
+        // Every thread only writes its own counters
+        const size_t threadIndex = JobSystem::GetThreadIndex();
+        if (threadIndex >= m_threads.size())
+        {
+            return;
+        }
+
+        auto& thread = m_threads[threadIndex];
+        auto& counters = category == Category::Component ? thread.components : thread.objects;
+        if (typeId >= counters.size())
+        {
+            counters.resize(typeId + 1);
+        }
+        counters[typeId].nanos += nanos;
+        counters[typeId].calls += calls;
+    }
+
+    void CostAccounting::WriteCsv()
+    {
+        std::vector<TypeCost> costs;
+        for (auto category : { Category::Component, Category::Object })
+        {
+            const bool isComponent = category == Category::Component;
+            BuildCosts(category, isComponent ? m_intervalComponents : m_intervalObjects, costs);
+            for (auto& cost : costs)
+            {
+                m_csv << m_frame << ","
+                    << (isComponent ? "component" : "object") << ","
+                    << cost.name << ","
+                    << cost.calls << ","
+                    << cost.ms << ","
+                    << cost.ms / m_intervalFrames << "\n";
+            }
+        }
+        m_csv.flush();
+
+        m_intervalFrames = 0;
+        m_intervalComponents.clear();
+        m_intervalObjects.clear();
+    }
+
+    void CostAccounting::Collect(std::vector<Counter>& counters, std::vector<Counter>& frame, std::vector<Counter>& interval)
+    {
+        if (frame.size() < counters.size())
+        {
+            frame.resize(counters.size());
+        }
+        if (interval.size() < counters.size())
+        {
+            interval.resize(counters.size());
+        }
+
+        for (size_t typeId = 0; typeId < counters.size(); ++typeId)
+        {
+            frame[typeId].nanos += counters[typeId].nanos;
+            frame[typeId].calls += counters[typeId].calls;
+            interval[typeId].nanos += counters[typeId].nanos;
+            interval[typeId].calls += counters[typeId].calls;
+            counters[typeId] = Counter();
+        }
+    }
+
+    void CostAccounting::BuildCosts(Category category, const std::vector<Counter>& counters, std::vector<TypeCost>& costs)
+    {
+        costs.clear();
+        for (size_t typeId = 0; typeId < counters.size(); ++typeId)
+        {
+            if (counters[typeId].calls == 0)
+            {
+                continue;
+            }
+
+            TypeCost cost;
+            cost.name = category == Category::Component
+                ? ComponentFactory::GetInstance().GetTypeName(typeId)
+                : GameObjectFactory::GetInstance().GetTypeName(typeId);
+            cost.typeId = typeId;
+            cost.calls = counters[typeId].calls;
+            cost.ms = counters[typeId].nanos / 1e6;
+            costs.push_back(cost);
+        }
+
+        std::sort(costs.begin(), costs.end(),
+            [](const TypeCost& a, const TypeCost& b) { return a.ms > b.ms; });
+    }
+
+    CostScope::CostScope(CostAccounting& accounting, CostAccounting::Category category, size_t typeId, uint64_t calls)
+        : m_category(category), m_typeId(typeId), m_calls(calls)
+    {
+        if (!accounting.m_enabled)
+        {
+            return;
+        }
+
+        m_accounting = &accounting;
+        m_outerNested = s_nestedNanos;
+        s_nestedNanos = 0;
+        m_start = Profiler::Now();
+    }
+
+    CostScope::~CostScope()
+    {
+        if (!m_accounting)
+        {
+            return;
+        }
+
+        const uint64_t elapsed = Profiler::Now() - m_start;
+        const uint64_t nested = std::min(s_nestedNanos, elapsed);
+        m_accounting->Add(m_category, m_typeId, elapsed - nested, m_calls);
+        s_nestedNanos = m_outerNested + elapsed;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace eng
+{
+    struct TypeCost
+    {
+        std::string name;
+        size_t typeId = 0;
+        uint64_t calls = 0;
+        double ms = 0.0;
+    };
+
+    // Time and call counts of the scene update per component type and per
+    // GameObject type. Time is exclusive, a scope nested in another one is
+    // only counted for the inner type, so the costs add up to the frame.
+    // Off by default. A disabled scope still costs two calls, so per-object
+    // loops check IsEnabled() once and skip the scopes.
+    class CostAccounting
+    {
+    public:
+        enum class Category
+        {
+            Component,
+            Object
+        };
+
+        void Init(size_t threadCount);
+        void SetEnabled(bool enabled);
+        bool IsEnabled() const;
+
+        // Appends the costs summed over every intervalFrames frames to a CSV
+        // file. An empty path stops the output.
+        bool SetCsvOutput(const std::string& path, size_t intervalFrames);
+
+        // Collects the costs of the frame, called once the update is done
+        void EndFrame();
+
+        // Costs of the last frame, most expensive first
+        const std::vector<TypeCost>& GetComponentCosts() const;
+        const std::vector<TypeCost>& GetObjectCosts() const;
+
+    private:
+        struct Counter
+        {
+            uint64_t nanos = 0;
+            uint64_t calls = 0;
+        };
+
+        struct ThreadCounters
+        {
+            std::vector<Counter> components;
+            std::vector<Counter> objects;
+        };
+
+        void Add(Category category, size_t typeId, uint64_t nanos, uint64_t calls);
+        void WriteCsv();
+        static void Collect(std::vector<Counter>& counters, std::vector<Counter>& frame, std::vector<Counter>& interval);
+        static void BuildCosts(Category category, const std::vector<Counter>& counters, std::vector<TypeCost>& costs);
+
+    private:
+        bool m_enabled = false;
+        std::vector<ThreadCounters> m_threads;
+        uint64_t m_frame = 0;
+
+        std::vector<Counter> m_frameComponents;
+        std::vector<Counter> m_frameObjects;
+        std::vector<TypeCost> m_componentCosts;
+        std::vector<TypeCost> m_objectCosts;
+
+        std::ofstream m_csv;
+        size_t m_csvInterval = 0;
+        size_t m_intervalFrames = 0;
+        std::vector<Counter> m_intervalComponents;
+        std::vector<Counter> m_intervalObjects;
+
+        friend class CostScope;
+    };
+
+    // Charges the time until the end of the scope to a type
+    class CostScope
+    {
+    public:
+        CostScope(CostAccounting& accounting, CostAccounting::Category category, size_t typeId, uint64_t calls = 1);
+        ~CostScope();
+        CostScope(const CostScope&) = delete;
+        CostScope& operator=(const CostScope&) = delete;
+
+    private:
+        CostAccounting* m_accounting = nullptr;
+        CostAccounting::Category m_category;
+        size_t m_typeId;
+        uint64_t m_calls;
+        uint64_t m_start = 0;
+        uint64_t m_outerNested = 0;
+    };
+}
\ No newline at end of file
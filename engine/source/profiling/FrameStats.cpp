@@ -0,0 +1,224 @@
+#include "profiling/FrameStats.h"
+#include "profiling/Profiler.h"
+
+#include <algorithm>
+#include <iostream>
+
+namespace eng
+{
+    FrameStats::FrameStats()
+    {
+        SetWindowSize(m_windowSize);
+    }
+
+    void FrameStats::AddStageTime(FrameStage stage, double ms)
+    {
+        m_current[static_cast<size_t>(stage)] += ms;
+    }
+
+    void FrameStats::EndFrame(double frameMs)
+    {
+        m_current[static_cast<size_t>(FrameStage::Frame)] = frameMs;
+
+        const size_t slot = m_frameCount % m_windowSize;
+        auto& frames = m_history[static_cast<size_t>(FrameStage::Frame)];
+        if (m_frameCount >= m_windowSize)
+        {
+            --m_histogram[GetBucket(frames[slot])];
+        }
+        ++m_histogram[GetBucket(frameMs)];
+
+        for (size_t stage = 0; stage < StageCount; ++stage)
+        {
+            m_history[stage][slot] = m_current[stage];
+            CheckBudget(static_cast<FrameStage>(stage), m_current[stage]);
+            m_current[stage] = 0.0;
+        }
+
+        // Compared to the median of the frames before, refreshed now and
+        // then as sorting the window every frame is not worth it
+        if (m_medianFrameMs > 0.0 && frameMs > m_hitchFactor * m_medianFrameMs)
+        {
+            ++m_hitchCount;
+            m_lastHitchFrame = m_frameCount;
+        }
+        ++m_frameCount;
+        if (m_frameCount % 30 == 0 || m_frameCount == 1)
+        {
+            m_medianFrameMs = GetStageStats(FrameStage::Frame).p50Ms;
+        }
+    }
+
+    void FrameStats::SetWindowSize(size_t frames)
+    {
+        m_windowSize = std::max<size_t>(frames, 1);
+        for (auto& history : m_history)
+        {
+            history.assign(m_windowSize, 0.0);
+        }
+        m_histogram.fill(0);
+        m_frameCount = 0;
+        m_medianFrameMs = 0.0;
+    }
+
+    size_t FrameStats::GetWindowSize() const
+    {
+        return m_windowSize;
+    }
+
+    uint64_t FrameStats::GetFrameCount() const
+    {
+        return m_frameCount;
+    }
+
+    StageStats FrameStats::GetStageStats(FrameStage stage) const
+    {
+        StageStats stats;
+        const size_t count = static_cast<size_t>(std::min<uint64_t>(m_frameCount, m_windowSize));
+        if (count == 0)
+        {
+            return stats;
+        }
+
+        const auto& history = m_history[static_cast<size_t>(stage)];
+        std::vector<double> values(history.begin(), history.begin() + count);
+        std::sort(values.begin(), values.end());
+
+        double total = 0.0;
+        for (auto value : values)
+        {
+            total += value;
+        }
+
+        const size_t last = count - 1;
+        stats.lastMs = history[(m_frameCount - 1) % m_windowSize];
+        stats.avgMs = total / count;
+        stats.p50Ms = values[last * 50 / 100];
+        stats.p95Ms = values[last * 95 / 100];
+        stats.p99Ms = values[last * 99 / 100];
+        stats.maxMs = values.back();
+        return stats;
+    }
+
+    const char* FrameStats::GetStageName(FrameStage stage)
+    {
+        switch (stage)
+        {
+        case FrameStage::Frame:
+            return "Frame";
+        case FrameStage::Physics:
+            return "Physics";
+        case FrameStage::Update:
+            return "Update";
+        case FrameStage::LateUpdate:
+            return "LateUpdate";
+        case FrameStage::Draw:
+            return "Draw";
+        case FrameStage::WaitForUpdate:
+            return "WaitForUpdate";
+        default:
+            return "Unknown";
+        }
+    }
+
+    const std::array<size_t, FrameStats::HistogramBuckets>& FrameStats::GetHistogram() const
+    {
+        return m_histogram;
+    }
+
+    const std::array<double, FrameStats::HistogramBuckets>& FrameStats::GetHistogramEdges()
+    {
+        static const std::array<double, HistogramBuckets> edges =
+        {
+            4.0, 8.0, 12.0, 16.7, 20.0, 25.0, 33.3, 50.0, 66.7, 100.0, 200.0, 1e30
+        };
+        return edges;
+    }
+
+    void FrameStats::SetHitchFactor(double factor)
+    {
+        m_hitchFactor = factor;
+    }
+
+    uint64_t FrameStats::GetHitchCount() const
+    {
+        return m_hitchCount;
+    }
+
+    uint64_t FrameStats::GetLastHitchFrame() const
+    {
+        return m_lastHitchFrame;
+    }
+
+    void FrameStats::SetBudget(FrameStage stage, double budgetMs, int consecutiveFrames, const BudgetCallback& callback)
+    {
+        auto& budget = m_budgets[static_cast<size_t>(stage)];
+        budget.budgetMs = budgetMs;
+        budget.consecutiveFrames = std::max(consecutiveFrames, 1);
+        budget.framesOver = 0;
+        budget.callback = callback;
+    }
+
+    void FrameStats::SetAllocationStats(const AllocationStats& frame, const AllocationStats& total)
+    {
+        m_frameAllocations = frame;
+        m_totalAllocations = total;
+    }
+
+    const AllocationStats& FrameStats::GetFrameAllocations() const
+    {
+        return m_frameAllocations;
+    }
+
+    const AllocationStats& FrameStats::GetTotalAllocations() const
+    {
+        return m_totalAllocations;
+    }
+
+    size_t FrameStats::GetBucket(double ms)
+    {
+        const auto& edges = GetHistogramEdges();
+        return std::lower_bound(edges.begin(), edges.end(), ms) - edges.begin();
+    }
+
+    void FrameStats::CheckBudget(FrameStage stage, double ms)
+    {
+        auto& budget = m_budgets[static_cast<size_t>(stage)];
+        if (budget.budgetMs <= 0.0)
+        {
+            return;
+        }
+
+        if (ms <= budget.budgetMs)
+        {
+            budget.framesOver = 0;
+            return;
+        }
+
+        if (++budget.framesOver != budget.consecutiveFrames)
+        {
+            return;
+        }
+
+        if (budget.callback)
+        {
+            budget.callback(stage, ms, budget.budgetMs, budget.framesOver);
+        }
+        else
+        {
+            std::cerr << "Frame budget: " << GetStageName(stage) << " took " << ms
+                << " ms, over its budget of " << budget.budgetMs << " ms for "
+                << budget.framesOver << " frames" << std::endl;
+        }
+    }
+
+    StageTimer::StageTimer(FrameStats& stats, FrameStage stage)
+        : m_stats(stats), m_stage(stage), m_start(Profiler::Now())
+    {
+    }
+
+    StageTimer::~StageTimer()
+    {
+        m_stats.AddStageTime(m_stage, (Profiler::Now() - m_start) / 1e6);
+    }
+}
\ No newline at end of file
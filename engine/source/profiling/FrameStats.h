@@ -0,0 +1,128 @@
+#pragma once
+
+#include "memory/PoolAllocator.h"
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace eng
+{
+    // Parts of a frame timed by the engine. Update covers UI input and the
+    // application, which updates the scene. LateUpdate covers the late
+    // systems and building the render frame.
+    enum class FrameStage
+    {
+        Frame,
+        Physics,
+        Update,
+        LateUpdate,
+        Draw,
+        WaitForUpdate,
+        Count
+    };
+
+    struct StageStats
+    {
+        double lastMs = 0.0;
+        double avgMs = 0.0;
+        double p50Ms = 0.0;
+        double p95Ms = 0.0;
+        double p99Ms = 0.0;
+        double maxMs = 0.0;
+    };
+
+    // Called when a stage went over its budget for the configured number of
+    // frames in a row. Fires once per streak.
+    using BudgetCallback = std::function<void(FrameStage stage, double ms, double budgetMs, int frames)>;
+
+    // Rolling stats over the last frames: per stage percentiles, a frame
+    // time histogram, hitches and budgets
+    class FrameStats
+    {
+    public:
+        static constexpr size_t StageCount = static_cast<size_t>(FrameStage::Count);
+        static constexpr size_t HistogramBuckets = 12;
+
+        FrameStats();
+
+        // Stage times add up within a frame, so fixed steps that run
+        // physics several times are counted in full. Different stages may
+        // be added from different threads.
+        void AddStageTime(FrameStage stage, double ms);
+        // Closes the frame, called by the engine once everything is done
+        void EndFrame(double frameMs);
+
+        void SetWindowSize(size_t frames);
+        size_t GetWindowSize() const;
+        uint64_t GetFrameCount() const;
+
+        StageStats GetStageStats(FrameStage stage) const;
+        static const char* GetStageName(FrameStage stage);
+
+        // Frames of the window per bucket, bucket i holds the frames up to
+        // GetHistogramEdges()[i] milliseconds, the last one everything above
+        const std::array<size_t, HistogramBuckets>& GetHistogram() const;
+        static const std::array<double, HistogramBuckets>& GetHistogramEdges();
+
+        // A hitch is a frame longer than factor times the median frame
+        void SetHitchFactor(double factor);
+        uint64_t GetHitchCount() const;
+        uint64_t GetLastHitchFrame() const;
+
+        // Without a callback the alarm is written to std::cerr. A budget of
+        // 0 removes it.
+        void SetBudget(FrameStage stage, double budgetMs, int consecutiveFrames, const BudgetCallback& callback = nullptr);
+
+        // Object pool counters of the last frame and since the start, set
+        // by the engine when it closes a frame
+        void SetAllocationStats(const AllocationStats& frame, const AllocationStats& total);
+        const AllocationStats& GetFrameAllocations() const;
+        const AllocationStats& GetTotalAllocations() const;
+
+    private:
+        struct Budget
+        {
+            double budgetMs = 0.0;
+            int consecutiveFrames = 1;
+            int framesOver = 0;
+            BudgetCallback callback;
+        };
+
+        static size_t GetBucket(double ms);
+        void CheckBudget(FrameStage stage, double ms);
+
+    private:
+        size_t m_windowSize = 300;
+        uint64_t m_frameCount = 0;
+        std::array<double, StageCount> m_current = {};
+        // Ring buffer per stage, m_windowSize frames each
+        std::array<std::vector<double>, StageCount> m_history;
+        std::array<size_t, HistogramBuckets> m_histogram = {};
+        std::array<Budget, StageCount> m_budgets;
+
+        double m_hitchFactor = 2.0;
+        double m_medianFrameMs = 0.0;
+        uint64_t m_hitchCount = 0;
+        uint64_t m_lastHitchFrame = 0;
+
+        AllocationStats m_frameAllocations;
+        AllocationStats m_totalAllocations;
+    };
+
+    // Adds the time until the end of the scope to a stage
+    class StageTimer
+    {
+    public:
+        StageTimer(FrameStats& stats, FrameStage stage);
+        ~StageTimer();
+        StageTimer(const StageTimer&) = delete;
+        StageTimer& operator=(const StageTimer&) = delete;
+
+    private:
+        FrameStats& m_stats;
+        FrameStage m_stage;
+        uint64_t m_start;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,188 @@
+#include "profiling/Profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <unordered_map>
+
+namespace eng
+{
+    static const auto s_startTime = std::chrono::steady_clock::now();
+
+    uint64_t Profiler::Now()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - s_startTime).count());
+    }
+
+    void Profiler::Record(const char* name, uint64_t start, uint64_t end)
+    {
+        auto& buffer = GetThreadBuffer();
+
+        // Only this thread writes the buffer. The index is published after
+        // the event, so a reader never sees a half written event as new.
+        const uint64_t index = buffer.writeIndex.load(std::memory_order_relaxed);
+        auto& event = buffer.events[index & (EventsPerThread - 1)];
+        event.name.store(name, std::memory_order_relaxed);
+        event.start.store(start, std::memory_order_relaxed);
+        event.end.store(end, std::memory_order_relaxed);
+        buffer.writeIndex.store(index + 1, std::memory_order_release);
+    }
+
+    std::vector<ZoneStats> Profiler::GetZoneStats()
+    {
+        std::unordered_map<std::string, std::vector<uint64_t>> durations;
+        for (auto& event : CollectEvents())
+        {
+            durations[event.name].push_back(event.end - event.start);
+        }
+
+        std::vector<ZoneStats> result;
+        result.reserve(durations.size());
+        for (auto& zone : durations)
+        {
+            auto& values = zone.second;
+            std::sort(values.begin(), values.end());
+
+            uint64_t total = 0;
+            for (auto value : values)
+            {
+                total += value;
+            }
+
+            ZoneStats stats;
+            stats.name = zone.first;
+            stats.count = values.size();
+            stats.minMs = values.front() / 1e6;
+            stats.avgMs = static_cast<double>(total) / values.size() / 1e6;
+            stats.p99Ms = values[(values.size() - 1) * 99 / 100] / 1e6;
+            stats.maxMs = values.back() / 1e6;
+            result.push_back(stats);
+        }
+
+        std::sort(result.begin(), result.end(),
+            [](const ZoneStats& a, const ZoneStats& b) { return a.avgMs > b.avgMs; });
+        return result;
+    }
+
+    void Profiler::WriteStatsTable(std::ostream& out)
+    {
+        out << std::left << std::setw(32) << "zone" << std::right
+            << std::setw(10) << "count"
+            << std::setw(12) << "min ms"
+            << std::setw(12) << "avg ms"
+            << std::setw(12) << "p99 ms"
+            << std::setw(12) << "max ms" << "\n";
+
+        out << std::fixed << std::setprecision(3);
+        for (auto& stats : GetZoneStats())
+        {
+            out << std::left << std::setw(32) << stats.name << std::right
+                << std::setw(10) << stats.count
+                << std::setw(12) << stats.minMs
+                << std::setw(12) << stats.avgMs
+                << std::setw(12) << stats.p99Ms
+                << std::setw(12) << stats.maxMs << "\n";
+        }
+    }
+
+    bool Profiler::WriteChromeTrace(const std::string& path)
+    {
+        std::ofstream file(path);
+        if (!file.is_open())
+        {
+            return false;
+        }
+
+        // Complete events, timestamps in microseconds
+        file << "{\"traceEvents\":[";
+        file << std::fixed << std::setprecision(3);
+        bool first = true;
+        for (auto& event : CollectEvents())
+        {
+            file << (first ? "\n" : ",\n");
+            file << "{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << event.threadId
+                << ",\"ts\":" << event.start / 1e3
+                << ",\"dur\":" << (event.end - event.start) / 1e3 << "}";
+            first = false;
+        }
+        file << "\n]}\n";
+
+        return file.good();
+    }
+
+    Profiler& Profiler::GetInstance()
+    {
+        static Profiler instance;
+        return instance;
+    }
+
+    Profiler::ThreadBuffer& Profiler::GetThreadBuffer()
+    {
+        // Registered once per thread. Buffers are kept after their thread
+        // exits, so its events still show up in the dumps.
+        static thread_local ThreadBuffer* threadBuffer = nullptr;
+        if (!threadBuffer)
+        {
+            auto& instance = GetInstance();
+            auto buffer = std::make_unique<ThreadBuffer>();
+            buffer->events = std::make_unique<Event[]>(EventsPerThread);
+
+            std::lock_guard<std::mutex> lock(instance.m_mutex);
+            buffer->threadId = static_cast<uint32_t>(instance.m_buffers.size());
+            threadBuffer = buffer.get();
+            instance.m_buffers.push_back(std::move(buffer));
+        }
+
+        return *threadBuffer;
+    }
+
+    std::vector<Profiler::EventCopy> Profiler::CollectEvents()
+    {
+        auto& instance = GetInstance();
+        std::lock_guard<std::mutex> lock(instance.m_mutex);
+
+        std::vector<EventCopy> result;
+        for (auto& buffer : instance.m_buffers)
+        {
+            const uint64_t end = buffer->writeIndex.load(std::memory_order_acquire);
+            const uint64_t begin = end > EventsPerThread ? end - EventsPerThread : 0;
+
+            const size_t firstCopied = result.size();
+            for (uint64_t i = begin; i < end; ++i)
+            {
+                auto& event = buffer->events[i & (EventsPerThread - 1)];
+                EventCopy copy;
+                copy.name = event.name.load(std::memory_order_relaxed);
+                copy.start = event.start.load(std::memory_order_relaxed);
+                copy.end = event.end.load(std::memory_order_relaxed);
+                copy.threadId = buffer->threadId;
+                result.push_back(copy);
+            }
+
+            // The owner kept writing during the copy, events it wrapped
+            // around to may be torn, so they are dropped. That includes the
+            // slot of endAfter, which may be half written right now.
+            const uint64_t endAfter = buffer->writeIndex.load(std::memory_order_acquire);
+            const uint64_t validBegin = endAfter >= EventsPerThread ? endAfter - EventsPerThread + 1 : 0;
+            if (validBegin > begin)
+            {
+                const size_t dropped = static_cast<size_t>(std::min(validBegin - begin, end - begin));
+                result.erase(result.begin() + firstCopied, result.begin() + firstCopied + dropped);
+            }
+        }
+
+        return result;
+    }
+
+    ProfileScope::ProfileScope(const char* name)
+        : m_name(name), m_start(Profiler::Now())
+    {
+    }
+
+    ProfileScope::~ProfileScope()
+    {
+        Profiler::Record(m_name, m_start, Profiler::Now());
+    }
+}
\ No newline at end of file
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace eng
+{
+    struct ZoneStats
+    {
+        std::string name;
+        size_t count = 0;
+        double minMs = 0.0;
+        double avgMs = 0.0;
+        double p99Ms = 0.0;
+        double maxMs = 0.0;
+    };
+
+    // Records named time ranges. Every thread writes to its own ring buffer
+    // without locking, once a buffer is full its oldest events are
+    // overwritten, so the stats always cover the most recent events.
+    class Profiler
+    {
+    public:
+        static constexpr size_t EventsPerThread = 1 << 16;
+
+        // Nanoseconds since the profiler started
+        static uint64_t Now();
+        // name has to outlive the profiler, normally a string literal
+        static void Record(const char* name, uint64_t start, uint64_t end);
+
+        // Per zone timings over the events currently in the buffers,
+        // slowest average first
+        static std::vector<ZoneStats> GetZoneStats();
+        static void WriteStatsTable(std::ostream& out);
+        // Chrome trace_event format, for chrome://tracing or Perfetto
+        static bool WriteChromeTrace(const std::string& path);
+
+    private:
+        struct Event
+        {
+            std::atomic<const char*> name = nullptr;
+            std::atomic<uint64_t> start = 0;
+            std::atomic<uint64_t> end = 0;
+        };
+
+        struct ThreadBuffer
+        {
+            uint32_t threadId = 0;
+            std::unique_ptr<Event[]> events;
+            std::atomic<uint64_t> writeIndex = 0;
+        };
+
+        struct EventCopy
+        {
+            const char* name = nullptr;
+            uint64_t start = 0;
+            uint64_t end = 0;
+            uint32_t threadId = 0;
+        };
+
+        static Profiler& GetInstance();
+        static ThreadBuffer& GetThreadBuffer();
+        static std::vector<EventCopy> CollectEvents();
+
+        std::mutex m_mutex;
+        std::vector<std::unique_ptr<ThreadBuffer>> m_buffers;
+    };
+
+    class ProfileScope
+    {
+    public:
+        explicit ProfileScope(const char* name);
+        ~ProfileScope();
+        ProfileScope(const ProfileScope&) = delete;
+        ProfileScope& operator=(const ProfileScope&) = delete;
+
+    private:
+        const char* m_name;
+        uint64_t m_start;
+    };
+}
+
+// Zones are only recorded when the engine is built with ENG_PROFILER on,
+// otherwise the macros compile to nothing
+#ifdef ENG_PROFILER_ENABLED
+#define ENG_PROFILE_CONCAT_INNER(a, b) a##b
+#define ENG_PROFILE_CONCAT(a, b) ENG_PROFILE_CONCAT_INNER(a, b)
+#define ENG_PROFILE_SCOPE(name) eng::ProfileScope ENG_PROFILE_CONCAT(profileScope, __LINE__)(name)
+#else
+#define ENG_PROFILE_SCOPE(name)
+#endif
\ No newline at end of file
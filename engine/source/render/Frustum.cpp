@@ -0,0 +1,66 @@
+#include "render/Frustum.h"
+
+#include <glm/geometric.hpp>
+
+namespace eng
+{
+    Frustum::Frustum(const glm::mat4& viewProjection)
+    {
+        // Planes from the rows of the matrix, glm stores columns
+        const glm::vec4 rowX(viewProjection[0][0], viewProjection[1][0], viewProjection[2][0], viewProjection[3][0]);
+        const glm::vec4 rowY(viewProjection[0][1], viewProjection[1][1], viewProjection[2][1], viewProjection[3][1]);
+        const glm::vec4 rowZ(viewProjection[0][2], viewProjection[1][2], viewProjection[2][2], viewProjection[3][2]);
+        const glm::vec4 rowW(viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]);
+
+        m_planes[0] = rowW + rowX;
+        m_planes[1] = rowW - rowX;
+        m_planes[2] = rowW + rowY;
+        m_planes[3] = rowW - rowY;
+        m_planes[4] = rowW + rowZ;
+        m_planes[5] = rowW - rowZ;
+
+        // Normalized, so the plane distance compares with a radius
+        for (auto& plane : m_planes)
+        {
+            const float length = glm::length(glm::vec3(plane));
+            if (length > 0.0f)
+            {
+                plane /= length;
+            }
+        }
+    }
+
+    bool Frustum::IntersectsSphere(const glm::vec3& center, float radius) const
+    {
+        for (const auto& plane : m_planes)
+        {
+            if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void Frustum::IntersectSpheres(const float* x, const float* y, const float* z, const float* radius,
+        size_t count, uint8_t* visible) const
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            visible[i] = 1;
+        }
+
+        for (const auto& plane : m_planes)
+        {
+            const float px = plane.x;
+            const float py = plane.y;
+            const float pz = plane.z;
+            const float pw = plane.w;
+            for (size_t i = 0; i < count; ++i)
+            {
+                const float distance = px * x[i] + py * y[i] + pz * z[i] + pw;
+                visible[i] &= static_cast<uint8_t>(distance >= -radius[i]);
+            }
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec4.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace eng
+{
+    // The six planes of a view projection, pointing inwards
+    class Frustum
+    {
+    public:
+        explicit Frustum(const glm::mat4& viewProjection);
+
+        bool IntersectsSphere(const glm::vec3& center, float radius) const;
+
+        // Tests spheres given as separate coordinate arrays, which keeps the
+        // plane loop free of branches so the compiler can vectorize it.
+        // visible[i] is set to 1 if sphere i touches the frustum, else 0.
+        void IntersectSpheres(const float* x, const float* y, const float* z, const float* radius,
+            size_t count, uint8_t* visible) const;
+
+    private:
+        std::array<glm::vec4, 6> m_planes;
+    };
+}
\ No newline at end of file
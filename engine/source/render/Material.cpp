@@ -5,8 +5,18 @@
 
 #include <nlohmann/json.hpp>
 
+#include <atomic>
+
 namespace eng
 {
+    // Materials may be loaded on worker threads
+    static std::atomic<uint32_t> s_nextSortId = 1;
+
+    Material::Material()
+        : m_sortId(s_nextSortId++)
+    {
+    }
+
     void Material::SetShaderProgram(const std::shared_ptr<ShaderProgram>& shaderProgram)
     {
         m_shaderProgram = shaderProgram;
@@ -17,24 +27,38 @@ namespace eng
         return m_shaderProgram.get();
     }
 
-    void Material::SetParam(const std::string& name, float value)
+    void Material::SetParam(UniformId id, float value)
     {
-        m_floatParams[name] = value;
+        SetParamValue(m_floatParams, id, value);
     }
 
-    void Material::SetParam(const std::string& name, float v0, float v1)
+    void Material::SetParam(UniformId id, float v0, float v1)
     {
-        m_float2Params[name] = { v0, v1 };
+        SetParamValue(m_float2Params, id, std::make_pair(v0, v1));
     }
 
-    void Material::SetParam(const std::string& name, const glm::vec3& value)
+    void Material::SetParam(UniformId id, const glm::vec3& value)
     {
-        m_float3Params[name] = value;
+        SetParamValue(m_float3Params, id, value);
     }
 
-    void Material::SetParam(const std::string& name, const std::shared_ptr<Texture>& texture)
+    void Material::SetParam(UniformId id, const std::shared_ptr<Texture>& texture)
     {
-        m_textures[name] = texture;
+        SetParamValue(m_textures, id, texture);
+    }
+
+    template<typename T>
+    void Material::SetParamValue(std::vector<Param<T>>& params, UniformId id, const T& value)
+    {
+        for (auto& param : params)
+        {
+            if (param.id.GetHash() == id.GetHash() && param.id.GetCheckHash() == id.GetCheckHash())
+            {
+                param.value = value;
+                return;
+            }
+        }
+        params.push_back({ id, value });
     }
 
     void Material::Bind()
@@ -45,28 +69,44 @@ namespace eng
         }
 
         m_shaderProgram->Bind();
+        ApplyParams(m_shaderProgram.get());
+    }
+
+    void Material::ApplyParams(ShaderProgram* shaderProgram)
+    {
+        if (!shaderProgram)
+        {
+            return;
+        }
+
+        shaderProgram->ResetTextureUnits();
 
         for (auto& param : m_floatParams)
         {
-            m_shaderProgram->SetUniform(param.first, param.second);
+            shaderProgram->SetUniform(param.id, param.value);
         }
 
         for (auto& param : m_float2Params)
         {
-            m_shaderProgram->SetUniform(param.first, param.second.first, param.second.second);
+            shaderProgram->SetUniform(param.id, param.value.first, param.value.second);
         }
 
         for (auto& param : m_float3Params)
         {
-            m_shaderProgram->SetUniform(param.first, param.second);
+            shaderProgram->SetUniform(param.id, param.value);
         }
 
         for (auto& param : m_textures)
         {
-            m_shaderProgram->SetTexture(param.first, param.second.get());
+            shaderProgram->SetTexture(param.id, param.value.get());
         }
     }
 
+    uint32_t Material::GetSortId() const
+    {
+        return m_sortId;
+    }
+
     std::shared_ptr<Material> Material::Load(const std::string& path)
     {
         auto contents = Engine::GetInstance().GetFileSystem().LoadAssetFileText(path);
@@ -1,33 +1,58 @@
 #pragma once
+#include "graphics/ShaderProgram.h"
+
+#include <cstdint>
 #include <memory>
-#include <unordered_map>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include <glm/vec3.hpp>
 
 namespace eng
 {
-    class ShaderProgram;
     class Texture;
 
     class Material
     {
     public:
+        Material();
+
         void SetShaderProgram(const std::shared_ptr<ShaderProgram>& shaderProgram);
         ShaderProgram* GetShaderProgram();
-        void SetParam(const std::string& name, float value);
-        void SetParam(const std::string& name, float v0, float v1);
-        void SetParam(const std::string& name, const glm::vec3& value);
-        void SetParam(const std::string& name, const std::shared_ptr<Texture>& texture);
+        // Params are kept by uniform id, the name is hashed once here
+        void SetParam(UniformId id, float value);
+        void SetParam(UniformId id, float v0, float v1);
+        void SetParam(UniformId id, const glm::vec3& value);
+        void SetParam(UniformId id, const std::shared_ptr<Texture>& texture);
         void Bind();
+        // Uploads the params to an already bound shader program, the
+        // material's own or a variant of it
+        void ApplyParams(ShaderProgram* shaderProgram);
+
+        // Small number that identifies the material in render sort keys
+        uint32_t GetSortId() const;
 
         static std::shared_ptr<Material> Load(const std::string& path);
 
     private:
+        template<typename T>
+        struct Param
+        {
+            UniformId id;
+            T value;
+        };
+
+        // Overwrites the param with the same id, if there is one
+        template<typename T>
+        static void SetParamValue(std::vector<Param<T>>& params, UniformId id, const T& value);
+
+    private:
+        uint32_t m_sortId = 0;
         std::shared_ptr<ShaderProgram> m_shaderProgram;
-        std::unordered_map<std::string, float> m_floatParams;
-        std::unordered_map<std::string, std::pair<float, float>> m_float2Params;
-        std::unordered_map<std::string, glm::vec3> m_float3Params;
-        std::unordered_map<std::string, std::shared_ptr<Texture>> m_textures;
+        std::vector<Param<float>> m_floatParams;
+        std::vector<Param<std::pair<float, float>>> m_float2Params;
+        std::vector<Param<glm::vec3>> m_float3Params;
+        std::vector<Param<std::shared_ptr<Texture>>> m_textures;
     };
 }
\ No newline at end of file
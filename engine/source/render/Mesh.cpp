@@ -2,11 +2,20 @@
 #include "graphics/GraphicsAPI.h"
 #include "Engine.h"
 
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
 namespace eng
 {
     Mesh::Mesh(const VertexLayout& layout, const std::vector<float>& vertices, const std::vector<uint32_t>& indices)
     {
+        Engine::GetInstance().CheckGraphicsThread("Mesh");
         m_vertexLayout = layout;
+        ComputeBounds(vertices.data(), vertices.size());
 
         auto& graphicsAPI = Engine::GetInstance().GetGraphicsAPI();
 
@@ -37,7 +46,9 @@ namespace eng
 
     Mesh::Mesh(const VertexLayout& layout, const std::vector<float>& vertices)
     {
+        Engine::GetInstance().CheckGraphicsThread("Mesh");
         m_vertexLayout = layout;
+        ComputeBounds(vertices.data(), vertices.size());
 
         auto& graphicsAPI = Engine::GetInstance().GetGraphicsAPI();
 
@@ -71,6 +82,119 @@ namespace eng
         glBindVertexArray(0);
     }
 
+    void Mesh::DrawInstanced(GLuint instanceBuffer, size_t firstInstance, size_t instanceCount)
+    {
+        // The matrix takes four vec4 attributes, pointed at the range of
+        // this draw, so one buffer serves all instanced draws of a frame
+        glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+        const size_t offset = firstInstance * sizeof(glm::mat4);
+        for (GLuint column = 0; column < 4; ++column)
+        {
+            const GLuint index = VertexElement::InstanceModelIndex + column;
+            glVertexAttribPointer(index, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4),
+                (void*)(uintptr_t)(offset + column * sizeof(glm::vec4)));
+            glEnableVertexAttribArray(index);
+            glVertexAttribDivisor(index, 1);
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        if (m_indexCount > 0)
+        {
+            glDrawElementsInstanced(GL_TRIANGLES, static_cast<GLsizei>(m_indexCount), GL_UNSIGNED_INT, 0,
+                static_cast<GLsizei>(instanceCount));
+        }
+        else
+        {
+            glDrawArraysInstanced(GL_TRIANGLES, 0, static_cast<GLsizei>(m_vertexCout),
+                static_cast<GLsizei>(instanceCount));
+        }
+
+        // The attributes are part of the VAO, left enabled they would feed
+        // later plain draws of the mesh from a stale range of the buffer
+        for (GLuint column = 0; column < 4; ++column)
+        {
+            glDisableVertexAttribArray(VertexElement::InstanceModelIndex + column);
+        }
+    }
+
+    GLuint Mesh::GetSortId() const
+    {
+        return m_VAO;
+    }
+
+    const AABB& Mesh::GetBounds() const
+    {
+        return m_bounds;
+    }
+
+    const BoundingSphere& Mesh::GetBoundingSphere() const
+    {
+        return m_boundingSphere;
+    }
+
+    void Mesh::ComputeBounds(const float* vertices, size_t floatCount)
+    {
+        // Nothing left of the previous contents of a dynamic mesh
+        m_bounds = AABB();
+        m_boundingSphere = BoundingSphere();
+
+        const VertexElement* position = nullptr;
+        for (const auto& element : m_vertexLayout.elements)
+        {
+            if (element.index == VertexElement::PositionIndex)
+            {
+                position = &element;
+            }
+        }
+
+        const size_t stride = m_vertexLayout.stride / sizeof(float);
+        if (!position || stride == 0 || floatCount < stride)
+        {
+            return;
+        }
+
+        // 2D layouts only store x and y
+        const size_t offset = position->offset / sizeof(float);
+        const size_t components = std::min<size_t>(position->size, 3);
+        auto readPosition = [&](size_t vertex)
+            {
+                glm::vec3 result(0.0f);
+                for (size_t i = 0; i < components; ++i)
+                {
+                    result[static_cast<int>(i)] = vertices[vertex * stride + offset + i];
+                }
+                return result;
+            };
+
+        const size_t vertexCount = floatCount / stride;
+        m_bounds.min = m_bounds.max = readPosition(0);
+        for (size_t i = 1; i < vertexCount; ++i)
+        {
+            const glm::vec3 pos = readPosition(i);
+            m_bounds.min = glm::min(m_bounds.min, pos);
+            m_bounds.max = glm::max(m_bounds.max, pos);
+        }
+
+        // Centered on the box, tighter than its half diagonal
+        m_boundingSphere.center = (m_bounds.min + m_bounds.max) * 0.5f;
+        float radiusSquared = 0.0f;
+        for (size_t i = 0; i < vertexCount; ++i)
+        {
+            const glm::vec3 offsetFromCenter = readPosition(i) - m_boundingSphere.center;
+            radiusSquared = std::max(radiusSquared, glm::dot(offsetFromCenter, offsetFromCenter));
+        }
+        m_boundingSphere.radius = std::sqrt(radiusSquared);
+    }
+
+    void Mesh::ClearBounds()
+    {
+        const float infinity = std::numeric_limits<float>::infinity();
+        m_bounds.min = glm::vec3(-infinity);
+        m_bounds.max = glm::vec3(infinity);
+        m_boundingSphere.center = glm::vec3(0.0f);
+        m_boundingSphere.radius = infinity;
+    }
+
     void Mesh::Draw()
     {
         if (m_indexCount > 0)
@@ -94,33 +218,55 @@ namespace eng
             reinterpret_cast<void*>(static_cast<size_t>(startIndex) * sizeof(uint32_t)));
     }
 
-    void Mesh::UpdateDynamic(const std::vector<float>& vertices)
+    void Mesh::UpdateDynamic(const std::vector<float>& vertices, bool computeBounds)
     {
         glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
         glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_DYNAMIC_DRAW);
         glBindBuffer(GL_ARRAY_BUFFER, 0);
         m_vertexCout = (vertices.size() * sizeof(float)) / m_vertexLayout.stride;
+        if (computeBounds)
+        {
+            ComputeBounds(vertices.data(), vertices.size());
+        }
+        else
+        {
+            ClearBounds();
+        }
+    }
+
+    void Mesh::UpdateDynamic(const std::vector<float>& vertices, const std::vector<uint32_t>& indices, bool computeBounds)
+    {
+        UpdateDynamic(vertices.data(), vertices.size(), indices.data(), indices.size(), computeBounds);
     }
 
-    void Mesh::UpdateDynamic(const std::vector<float>& vertices, const std::vector<uint32_t>& indices)
+    void Mesh::UpdateDynamic(const float* vertices, size_t vertexCount, const uint32_t* indices, size_t indexCount,
+        bool computeBounds)
     {
         glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
-        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_DYNAMIC_DRAW);
+        glBufferData(GL_ARRAY_BUFFER, vertexCount * sizeof(float), vertices, GL_DYNAMIC_DRAW);
         glBindBuffer(GL_ARRAY_BUFFER, 0);
-        m_vertexCout = (vertices.size() * sizeof(float)) / m_vertexLayout.stride;
+        m_vertexCout = (vertexCount * sizeof(float)) / m_vertexLayout.stride;
+        if (computeBounds)
+        {
+            ComputeBounds(vertices, vertexCount);
+        }
+        else
+        {
+            ClearBounds();
+        }
 
         if (m_EBO == 0)
         {
-            Engine::GetInstance().GetGraphicsAPI().CreateIndexBuffer(indices);
+            Engine::GetInstance().GetGraphicsAPI().CreateIndexBuffer(std::vector<uint32_t>(indices, indices + indexCount));
         }
         else
         {
             glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
             glBufferData(GL_ELEMENT_ARRAY_BUFFER, 
-                indices.size() * sizeof(uint32_t), indices.data(), GL_DYNAMIC_DRAW);
+                indexCount * sizeof(uint32_t), indices, GL_DYNAMIC_DRAW);
             glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
         }
-        m_indexCount = indices.size();
+        m_indexCount = indexCount;
     }
 
     std::shared_ptr<Mesh> Mesh::CreateBox(const glm::vec3& extents)
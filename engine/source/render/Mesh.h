@@ -3,12 +3,25 @@
 #include "graphics/VertexLayout.h"
 
 #include <glm//vec3.hpp>
+#include <glm/mat4x4.hpp>
 
 #include <memory>
 #include <string>
 
 namespace eng
 {
+    struct AABB
+    {
+        glm::vec3 min = glm::vec3(0.0f);
+        glm::vec3 max = glm::vec3(0.0f);
+    };
+
+    struct BoundingSphere
+    {
+        glm::vec3 center = glm::vec3(0.0f);
+        float radius = 0.0f;
+    };
+
     class Mesh
     {
     public:
@@ -21,13 +34,31 @@ namespace eng
         void Unbind();
         void Draw();
         void DrawIndexedRange(uint32_t startIndex, uint32_t indexCount);
-        void UpdateDynamic(const std::vector<float>& vertices);
-        void UpdateDynamic(const std::vector<float>& vertices, const std::vector<uint32_t>& indices);
+        // Draws one instance per model matrix in the instance buffer range,
+        // the mesh has to be bound
+        void DrawInstanced(GLuint instanceBuffer, size_t firstInstance, size_t instanceCount);
+        // The GL vertex array name, unique while the mesh lives
+        GLuint GetSortId() const;
+
+        // Bounds of the vertex positions, computed at construction and by
+        // UpdateDynamic
+        const AABB& GetBounds() const;
+        const BoundingSphere& GetBoundingSphere() const;
+        // Without computeBounds the mesh is unbounded and never culled, for
+        // meshes that are not culled anyway, like the UI canvas
+        void UpdateDynamic(const std::vector<float>& vertices, bool computeBounds = true);
+        void UpdateDynamic(const std::vector<float>& vertices, const std::vector<uint32_t>& indices, bool computeBounds = true);
+        void UpdateDynamic(const float* vertices, size_t vertexCount, const uint32_t* indices, size_t indexCount,
+            bool computeBounds = true);
 
         static std::shared_ptr<Mesh> CreateBox(const glm::vec3& extents = glm::vec3(1.0f));
         static std::shared_ptr<Mesh> CreateSphere(float radius, int sectors, int stacks);
         static std::shared_ptr<Mesh> CreatePlane();
 
+    private:
+        void ComputeBounds(const float* vertices, size_t floatCount);
+        void ClearBounds();
+
     private:
         VertexLayout m_vertexLayout;
         GLuint m_VBO = 0;
@@ -36,5 +67,8 @@ namespace eng
 
         size_t m_vertexCout = 0;
         size_t m_indexCount = 0;
+
+        AABB m_bounds;
+        BoundingSphere m_boundingSphere;
     };
 }
\ No newline at end of file
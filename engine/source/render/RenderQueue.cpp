@@ -1,96 +1,484 @@
 #include "render/RenderQueue.h"
 #include "render/Mesh.h"
 #include "render/Material.h"
+#include "render/Frustum.h"
 #include "graphics/GraphicsAPI.h"
 #include "graphics/ShaderProgram.h"
+#include "jobs/JobSystem.h"
+#include "profiling/Profiler.h"
+#include "Engine.h"
 
 #include <glm/gtc/matrix_transform.hpp>
 
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <numeric>
+
 namespace eng
 {
+    static thread_local uint32_t s_submitOrder = 0;
+
+    // Uniforms set per command, hashed at compile time
+    static constexpr UniformId s_modelUniform("uModel");
+    static constexpr UniformId s_viewUniform("uView");
+    static constexpr UniformId s_projectionUniform("uProjection");
+    static constexpr UniformId s_sizeUniform("uSize");
+    static constexpr UniformId s_pivotUniform("uPivot");
+    static constexpr UniformId s_uvMinUniform("uUVMin");
+    static constexpr UniformId s_uvMaxUniform("uUVMax");
+    static constexpr UniformId s_colorUniform("uColor");
+    static constexpr UniformId s_textureUniform("uTex");
+    static constexpr UniformId s_useTextureUniform("uUseTexture");
+
+    RenderQueue::RenderQueue()
+        : m_threadBuffers(1)
+    {
+    }
+
     void RenderQueue::Init()
     {
         m_mesh2D = Mesh::CreatePlane();
+        m_instanceBuffer = Engine::GetInstance().GetGraphicsAPI().CreateVertexBuffer({});
+        m_threadBuffers.resize(Engine::GetInstance().GetJobSystem().GetThreadCount());
     }
 
     void RenderQueue::Submit(const RenderCommand& command)
     {
-        m_commands.push_back(command);
+        auto& buffer = GetThreadBuffer().commands;
+        buffer.commands.push_back(command);
+        buffer.orders.push_back(s_submitOrder);
     }
 
     void RenderQueue::Submit(const RenderCommand2D& command)
     {
-        m_commands2D.push_back(command);
+        auto& buffer = GetThreadBuffer().commands2D;
+        buffer.commands.push_back(command);
+        buffer.orders.push_back(s_submitOrder);
+    }
+
+    void RenderQueue::Submit(RenderCommandUI command)
+    {
+        auto& buffer = GetThreadBuffer().commandsUI;
+        buffer.commands.push_back(std::move(command));
+        buffer.orders.push_back(s_submitOrder);
+    }
+
+    void RenderQueue::SetSubmitOrder(uint32_t order)
+    {
+        s_submitOrder = order;
+    }
+
+    RenderQueue::ThreadBuffer& RenderQueue::GetThreadBuffer()
+    {
+        const size_t index = JobSystem::GetThreadIndex();
+        return m_threadBuffers[index < m_threadBuffers.size() ? index : 0];
+    }
+
+    template<typename T>
+    void RenderQueue::MergeThreadBuffers(OrderedCommands<T> ThreadBuffer::* member, std::vector<T>& out)
+    {
+        // The frame still holds the commands it was last built with
+        out.clear();
+        size_t usedBuffers = 0;
+        size_t total = 0;
+        for (auto& buffer : m_threadBuffers)
+        {
+            const size_t count = (buffer.*member).commands.size();
+            usedBuffers += count > 0 ? 1 : 0;
+            total += count;
+        }
+
+        // Single threaded submits keep their order as is
+        if (usedBuffers <= 1)
+        {
+            for (auto& buffer : m_threadBuffers)
+            {
+                auto& source = buffer.*member;
+                if (!source.commands.empty())
+                {
+                    out.swap(source.commands);
+                    source.commands.clear();
+                    source.orders.clear();
+                }
+            }
+            return;
+        }
+
+        std::vector<uint32_t> orders;
+        out.reserve(total);
+        orders.reserve(total);
+        for (auto& buffer : m_threadBuffers)
+        {
+            auto& source = buffer.*member;
+            std::move(source.commands.begin(), source.commands.end(), std::back_inserter(out));
+            orders.insert(orders.end(), source.orders.begin(), source.orders.end());
+            source.commands.clear();
+            source.orders.clear();
+        }
+
+        std::vector<size_t> permutation(total);
+        std::iota(permutation.begin(), permutation.end(), 0);
+        std::stable_sort(permutation.begin(), permutation.end(),
+            [&orders](size_t a, size_t b) { return orders[a] < orders[b]; });
+
+        std::vector<T> sorted;
+        sorted.reserve(total);
+        for (auto index : permutation)
+        {
+            sorted.push_back(std::move(out[index]));
+        }
+        out.swap(sorted);
+    }
+
+    uint64_t RenderQueue::MakeSortKey(const RenderCommand& command, const glm::vec3& cameraPosition)
+    {
+        const auto shaderProgram = command.material->GetShaderProgram();
+        const uint64_t shaderId = shaderProgram ? shaderProgram->GetSortId() : 0;
+        const uint64_t materialId = command.material->GetSortId();
+        const uint64_t meshId = command.mesh->GetSortId();
+
+        // The upper bits of a positive float sort like the float itself
+        const glm::vec3 offset = glm::vec3(command.modelMatrix[3]) - cameraPosition;
+        const float distance = glm::dot(offset, offset);
+        uint32_t distanceBits = 0;
+        std::memcpy(&distanceBits, &distance, sizeof(distanceBits));
+        const uint64_t depth = distanceBits >> 16;
+
+        return (static_cast<uint64_t>(command.pass & 0xF) << 60) |
+            ((shaderId & 0xFFF) << 48) |
+            ((materialId & 0xFFFF) << 32) |
+            ((meshId & 0xFFFF) << 16) |
+            (depth & 0xFFFF);
     }
 
-    void RenderQueue::Submit(const RenderCommandUI& command)
+    void RenderQueue::RadixSort(std::vector<SortItem>& items, std::vector<SortItem>& scratch)
     {
-        m_commandsUI.push_back(command);
+        const size_t count = items.size();
+        if (count < 2)
+        {
+            return;
+        }
+
+        std::array<std::array<uint32_t, 256>, 8> histograms = {};
+        for (const auto& item : items)
+        {
+            for (size_t digit = 0; digit < 8; ++digit)
+            {
+                ++histograms[digit][(item.key >> (digit * 8)) & 0xFF];
+            }
+        }
+
+        scratch.resize(count);
+        for (size_t digit = 0; digit < 8; ++digit)
+        {
+            const size_t shift = digit * 8;
+            auto& histogram = histograms[digit];
+
+            // All keys share this byte, the pass would not change the order
+            if (histogram[(items[0].key >> shift) & 0xFF] == count)
+            {
+                continue;
+            }
+
+            uint32_t offset = 0;
+            for (auto& bucket : histogram)
+            {
+                const uint32_t bucketCount = bucket;
+                bucket = offset;
+                offset += bucketCount;
+            }
+
+            for (const auto& item : items)
+            {
+                scratch[histogram[(item.key >> shift) & 0xFF]++] = item;
+            }
+            items.swap(scratch);
+        }
     }
 
-    void RenderQueue::Draw(GraphicsAPI& graphicsAPI, const CameraData& cameraData, const std::vector<LightData>& lights)
+    void RenderQueue::BuildBatches(Frame& frame)
     {
-        // 3D
-        for (auto& command : m_commands)
+        frame.batches.clear();
+        frame.instances.clear();
+
+        const auto& items = frame.sortItems;
+        size_t first = 0;
+        while (first < items.size())
         {
-            graphicsAPI.BindMaterial(command.material);
+            const auto& command = frame.commands[items[first].index];
+            size_t end = first + 1;
+            while (end < items.size())
+            {
+                const auto& next = frame.commands[items[end].index];
+                if (next.mesh != command.mesh || next.material != command.material)
+                {
+                    break;
+                }
+                ++end;
+            }
+
+            DrawBatch batch;
+            batch.first = static_cast<uint32_t>(first);
+            batch.count = static_cast<uint32_t>(end - first);
+
             auto shaderProgram = command.material->GetShaderProgram();
-            shaderProgram->SetUniform("uModel", command.modelMatrix);
-            shaderProgram->SetUniform("uView", cameraData.viewMatrix);
-            shaderProgram->SetUniform("uProjection", cameraData.projectionMatrix);
-            shaderProgram->SetUniform("uCameraPos", cameraData.position);
-            if (!lights.empty())
+            if (batch.count >= MinInstances && shaderProgram && shaderProgram->GetInstancedVariant())
             {
-                auto& light = lights[0];
-                shaderProgram->SetUniform("uLight.color", light.color);
-                shaderProgram->SetUniform("uLight.direction", glm::normalize(-light.position));
+                batch.instanced = true;
+                batch.firstInstance = static_cast<uint32_t>(frame.instances.size());
+                for (size_t i = first; i < end; ++i)
+                {
+                    frame.instances.push_back(frame.commands[items[i].index].modelMatrix);
+                }
             }
 
-            graphicsAPI.BindMesh(command.mesh);
-            graphicsAPI.DrawMesh(command.mesh);
-            graphicsAPI.UnbindMesh(command.mesh);
+            frame.batches.push_back(batch);
+            first = end;
         }
+    }
 
-        m_commands.clear();
+    void RenderQueue::CullCommands(const std::vector<RenderCommand>& commands, const CameraData& cameraData)
+    {
+        ENG_PROFILE_SCOPE("RenderQueue::CullCommands");
+        const size_t count = commands.size();
+        auto& cull = m_cullBuffers;
+        cull.visible.resize(count);
+
+        // Nothing to transform when every command with a mesh is drawn
+        if (!m_cullingEnabled)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                cull.visible[i] = commands[i].mesh ? 1 : 0;
+            }
+            return;
+        }
+
+        cull.x.resize(count);
+        cull.y.resize(count);
+        cull.z.resize(count);
+        cull.radius.resize(count);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const auto& command = commands[i];
+            if (!command.mesh)
+            {
+                // Behind every plane, so the test drops it
+                cull.x[i] = cull.y[i] = cull.z[i] = 0.0f;
+                cull.radius[i] = -std::numeric_limits<float>::infinity();
+                continue;
+            }
+
+            const auto& sphere = command.mesh->GetBoundingSphere();
+            const auto& model = command.modelMatrix;
+            const glm::vec3 center = glm::vec3(model * glm::vec4(sphere.center, 1.0f));
+            const float scale = std::max({
+                glm::length(glm::vec3(model[0])),
+                glm::length(glm::vec3(model[1])),
+                glm::length(glm::vec3(model[2])) });
+            cull.x[i] = center.x;
+            cull.y[i] = center.y;
+            cull.z[i] = center.z;
+            cull.radius[i] = sphere.radius * scale;
+        }
+
+        const Frustum frustum(cameraData.projectionMatrix * cameraData.viewMatrix);
+        frustum.IntersectSpheres(cull.x.data(), cull.y.data(), cull.z.data(), cull.radius.data(),
+            count, cull.visible.data());
+    }
+
+    void RenderQueue::EndFrame(const CameraData& cameraData, FrameVector<LightData> lights, float time)
+    {
+        ENG_PROFILE_SCOPE("RenderQueue::EndFrame");
+        auto& frame = m_frames[1 - m_frontFrame];
+        MergeThreadBuffers(&ThreadBuffer::commands, frame.commands);
+
+        CullCommands(frame.commands, cameraData);
+
+        frame.sortItems.clear();
+        frame.sortItems.reserve(frame.commands.size());
+        for (size_t i = 0; i < frame.commands.size(); ++i)
+        {
+            const auto& command = frame.commands[i];
+            if (m_cullBuffers.visible[i] && command.material)
+            {
+                frame.sortItems.push_back({ MakeSortKey(command, cameraData.position), static_cast<uint32_t>(i) });
+            }
+        }
+        frame.culledCommands = frame.commands.size() - frame.sortItems.size();
+        RadixSort(frame.sortItems, frame.sortScratch);
+        BuildBatches(frame);
+
+        MergeThreadBuffers(&ThreadBuffer::commands2D, frame.commands2D);
+        MergeThreadBuffers(&ThreadBuffer::commandsUI, frame.commandsUI);
+        frame.cameraData = cameraData;
+        frame.lights = std::move(lights);
+        frame.time = time;
+    }
+
+    void RenderQueue::SwapFrames()
+    {
+        m_frontFrame = 1 - m_frontFrame;
+    }
+
+    void RenderQueue::ClearFrames()
+    {
+        for (auto& frame : m_frames)
+        {
+            frame.commands.clear();
+            frame.sortItems.clear();
+            frame.batches.clear();
+            frame.instances.clear();
+            frame.culledCommands = 0;
+            frame.commands2D.clear();
+            frame.commandsUI.clear();
+            frame.lights.clear();
+        }
+    }
+
+    void RenderQueue::Draw(GraphicsAPI& graphicsAPI)
+    {
+        ENG_PROFILE_SCOPE("RenderQueue::Draw");
+        auto& frame = m_frames[m_frontFrame];
+        const auto& cameraData = frame.cameraData;
+        const auto& lights = frame.lights;
+
+        // Camera, light and time for every program with a FrameData block
+        FrameUniforms frameUniforms;
+        frameUniforms.view = cameraData.viewMatrix;
+        frameUniforms.projection = cameraData.projectionMatrix;
+        frameUniforms.cameraPos = cameraData.position;
+        frameUniforms.time = frame.time;
+        if (!lights.empty())
+        {
+            frameUniforms.lightColor = lights[0].color;
+            frameUniforms.lightDirection = glm::normalize(-lights[0].position);
+        }
+        graphicsAPI.UpdateFrameUniforms(frameUniforms);
+
+        // 3D, in key order. State is only changed when it differs from the
+        // previous batch.
+        m_stats = RenderQueueStats();
+        m_stats.visibleCommands = frame.sortItems.size();
+        m_stats.culledCommands = frame.culledCommands;
+        if (!frame.instances.empty())
+        {
+            graphicsAPI.UpdateVertexBuffer(m_instanceBuffer, frame.instances.data(),
+                frame.instances.size() * sizeof(glm::mat4));
+        }
+
+        ShaderProgram* currentProgram = nullptr;
+        Material* currentMaterial = nullptr;
+        Mesh* currentMesh = nullptr;
+        for (const auto& batch : frame.batches)
+        {
+            const auto& firstCommand = frame.commands[frame.sortItems[batch.first].index];
+            auto material = firstCommand.material;
+            auto mesh = firstCommand.mesh;
+            auto shaderProgram = material->GetShaderProgram();
+            if (!shaderProgram)
+            {
+                continue;
+            }
+            if (batch.instanced)
+            {
+                shaderProgram = shaderProgram->GetInstancedVariant();
+            }
+
+            if (shaderProgram != currentProgram)
+            {
+                shaderProgram->Bind();
+                currentProgram = shaderProgram;
+                currentMaterial = nullptr;
+                ++m_stats.programChanges;
+            }
+
+            if (material != currentMaterial)
+            {
+                material->ApplyParams(shaderProgram);
+                currentMaterial = material;
+                ++m_stats.materialChanges;
+            }
+
+            if (mesh != currentMesh)
+            {
+                mesh->Bind();
+                currentMesh = mesh;
+                ++m_stats.meshChanges;
+            }
+
+            if (batch.instanced)
+            {
+                mesh->DrawInstanced(m_instanceBuffer, batch.firstInstance, batch.count);
+                ++m_stats.drawCalls;
+                ++m_stats.instancedDraws;
+                m_stats.instances += batch.count;
+                continue;
+            }
+
+            for (uint32_t i = batch.first; i < batch.first + batch.count; ++i)
+            {
+                shaderProgram->SetUniform(s_modelUniform, frame.commands[frame.sortItems[i].index].modelMatrix);
+                mesh->Draw();
+                ++m_stats.drawCalls;
+            }
+        }
+        if (currentMesh)
+        {
+            currentMesh->Unbind();
+        }
+
+        frame.commands.clear();
+        frame.sortItems.clear();
+        frame.batches.clear();
+        frame.instances.clear();
 
         // 2D
         graphicsAPI.SetDepthTestEnabled(false);
         graphicsAPI.SetBlendMode(BlendMode::Alpha);
         const auto shaderProgram2D = graphicsAPI.GetDefault2DShaderProgram();
         shaderProgram2D->Bind();
+        // Same for every sprite, sprites project with the ortho matrix
+        // rather than the one in FrameData
+        shaderProgram2D->SetUniform(s_viewUniform, cameraData.viewMatrix);
+        shaderProgram2D->SetUniform(s_projectionUniform, cameraData.orthoMatrix);
         m_mesh2D->Bind();
-        for (auto& command : m_commands2D)
+        for (auto& command : frame.commands2D)
         {
             // rendering
-            shaderProgram2D->SetUniform("uModel", command.modelMatrix);
-            shaderProgram2D->SetUniform("uView", cameraData.viewMatrix);
-            shaderProgram2D->SetUniform("uProjection", cameraData.orthoMatrix);
-            shaderProgram2D->SetUniform("uSize", command.size.x, command.size.y);
-            shaderProgram2D->SetUniform("uPivot", command.pivot.x, command.pivot.y);
-            shaderProgram2D->SetUniform("uUVMin", command.lowerLeftUV.x, command.lowerLeftUV.y);
-            shaderProgram2D->SetUniform("uUVMax", command.upperRightUV.x, command.upperRightUV.y);
-            shaderProgram2D->SetUniform("uColor", command.color);
-            shaderProgram2D->SetTexture("uTex", command.texture);
+            shaderProgram2D->SetUniform(s_modelUniform, command.modelMatrix);
+            shaderProgram2D->SetUniform(s_sizeUniform, command.size.x, command.size.y);
+            shaderProgram2D->SetUniform(s_pivotUniform, command.pivot.x, command.pivot.y);
+            shaderProgram2D->SetUniform(s_uvMinUniform, command.lowerLeftUV.x, command.lowerLeftUV.y);
+            shaderProgram2D->SetUniform(s_uvMaxUniform, command.upperRightUV.x, command.upperRightUV.y);
+            shaderProgram2D->SetUniform(s_colorUniform, command.color);
+            shaderProgram2D->SetTexture(s_textureUniform, command.texture);
             m_mesh2D->Draw();
 
         }
         m_mesh2D->Unbind();
         graphicsAPI.SetBlendMode(BlendMode::Disabled);
         graphicsAPI.SetDepthTestEnabled(true);
-        m_commands2D.clear();
+        frame.commands2D.clear();
 
         // UI
         graphicsAPI.SetDepthTestEnabled(false);
         graphicsAPI.SetBlendMode(BlendMode::Alpha);
-        for (auto& command : m_commandsUI)
+        for (auto& command : frame.commandsUI)
         {
             glm::mat4 ortho = glm::ortho(
                 0.0f, static_cast<float>(command.screenWidth),
                 0.0f, static_cast<float>(command.screenHeight)
             );
             command.shaderProgram->Bind();
-            command.shaderProgram->SetUniform("uProjection", ortho);
+            command.shaderProgram->SetUniform(s_projectionUniform, ortho);
 
+            // UI commands are never culled
+            command.mesh->UpdateDynamic(
+                command.vertices.data(), command.vertices.size(),
+                command.indices.data(), command.indices.size(), false);
             command.mesh->Bind();
 
             uint32_t indexBase = 0;
@@ -98,12 +486,12 @@ namespace eng
             {
                 if (batch.texture)
                 {
-                    command.shaderProgram->SetUniform("uUseTexture", 1);
-                    command.shaderProgram->SetTexture("uTex", batch.texture);
+                    command.shaderProgram->SetUniform(s_useTextureUniform, 1);
+                    command.shaderProgram->SetTexture(s_textureUniform, batch.texture);
                 }
                 else
                 {
-                    command.shaderProgram->SetUniform("uUseTexture", 0);
+                    command.shaderProgram->SetUniform(s_useTextureUniform, 0);
                 }
                 command.mesh->DrawIndexedRange(indexBase, batch.indexCount);
                 indexBase += batch.indexCount;
@@ -112,6 +500,21 @@ namespace eng
         }
         graphicsAPI.SetBlendMode(BlendMode::Disabled);
         graphicsAPI.SetDepthTestEnabled(true);
-        m_commandsUI.clear();
+        frame.commandsUI.clear();
+    }
+
+    const RenderQueueStats& RenderQueue::GetStats() const
+    {
+        return m_stats;
+    }
+
+    void RenderQueue::SetCullingEnabled(bool enabled)
+    {
+        m_cullingEnabled = enabled;
+    }
+
+    bool RenderQueue::IsCullingEnabled() const
+    {
+        return m_cullingEnabled;
     }
 }
\ No newline at end of file
@@ -1,7 +1,10 @@
 #pragma once
 
 #include "Common.h"
+#include "memory/FrameAllocator.h"
+#include <glad/glad.h>
 #include <glm/mat4x4.hpp>
+#include <array>
 #include <vector>
 #include <memory>
 
@@ -18,6 +21,21 @@ namespace eng
         Mesh* mesh = nullptr;
         Material* material = nullptr;
         glm::mat4 modelMatrix;
+        // Commands of a lower pass are drawn first
+        uint8_t pass = 0;
+    };
+
+    // State changes of the last drawn frame, 3D commands only
+    struct RenderQueueStats
+    {
+        size_t visibleCommands = 0;
+        size_t culledCommands = 0;
+        size_t drawCalls = 0;
+        size_t instancedDraws = 0;
+        size_t instances = 0;
+        size_t programChanges = 0;
+        size_t materialChanges = 0;
+        size_t meshChanges = 0;
     };
 
     struct RenderCommand2D
@@ -37,22 +55,130 @@ namespace eng
         ShaderProgram* shaderProgram;
         size_t screenWidth;
         size_t screenHeight;
-        std::vector<UIBatch> batches;
+        FrameVector<UIBatch> batches;
+        // Uploaded to the mesh in Draw, so the command can be built without GL
+        FrameVector<float> vertices;
+        FrameVector<uint32_t> indices;
     };
 
     class RenderQueue
     {
     public:
+        RenderQueue();
         void Init();
         void Submit(const RenderCommand& command);
         void Submit(const RenderCommand2D& command);
-        void Submit(const RenderCommandUI& command);
-        void Draw(GraphicsAPI& graphicsAPI, const CameraData& cameraData, const std::vector<LightData>& lights);
+        void Submit(RenderCommandUI command);
+
+        // Moves the submitted commands into the back frame together with
+        // the camera and lights, culls the 3D commands against the camera
+        // frustum and sorts the visible ones by their key.
+        // Runs of commands with the same mesh and material become one
+        // instanced draw if the shader has an instanced variant.
+        // Draw only reads the front frame, so the next frame can be built
+        // while the previous one is drawn.
+        void EndFrame(const CameraData& cameraData, FrameVector<LightData> lights, float time = 0.0f);
+        void SwapFrames();
+        // Drops both built frames, so nothing is drawn until the next
+        // EndFrame. For when the commands in them may point to freed
+        // resources.
+        void ClearFrames();
+        void Draw(GraphicsAPI& graphicsAPI);
+        const RenderQueueStats& GetStats() const;
+
+        // Culling is on by default
+        void SetCullingEnabled(bool enabled);
+        bool IsCullingEnabled() const;
+
+        // Packs pass (4 bits), shader (12), material (16), mesh (16) and
+        // depth (16) from high to low bits, so sorting groups commands by
+        // state and draws each group front to back
+        static uint64_t MakeSortKey(const RenderCommand& command, const glm::vec3& cameraPosition);
+
+        // Commands are submitted to a buffer of the calling thread. Draw
+        // merges the buffers ordered by this key, which a parallel scene
+        // update sets to the index of the root object being updated.
+        static void SetSubmitOrder(uint32_t order);
+
+    private:
+        // Shorter runs are drawn one by one
+        static constexpr uint32_t MinInstances = 2;
+
+        template<typename T>
+        struct OrderedCommands
+        {
+            std::vector<T> commands;
+            std::vector<uint32_t> orders;
+        };
+
+        struct ThreadBuffer
+        {
+            OrderedCommands<RenderCommand> commands;
+            OrderedCommands<RenderCommand2D> commands2D;
+            OrderedCommands<RenderCommandUI> commandsUI;
+        };
+
+        struct SortItem
+        {
+            uint64_t key;
+            uint32_t index;
+        };
+
+        // Commands of the sort order in [first, first + count)
+        struct DrawBatch
+        {
+            uint32_t first = 0;
+            uint32_t count = 0;
+            // Offset into the frame's instance matrices, if instanced
+            uint32_t firstInstance = 0;
+            bool instanced = false;
+        };
+
+        struct Frame
+        {
+            std::vector<RenderCommand> commands;
+            // Draw order of the commands
+            std::vector<SortItem> sortItems;
+            std::vector<SortItem> sortScratch;
+            std::vector<DrawBatch> batches;
+            std::vector<glm::mat4> instances;
+            size_t culledCommands = 0;
+            std::vector<RenderCommand2D> commands2D;
+            std::vector<RenderCommandUI> commandsUI;
+            CameraData cameraData;
+            FrameVector<LightData> lights;
+            float time = 0.0f;
+        };
+
+        // World bounding spheres of the commands of a frame, one array per
+        // coordinate for the frustum test
+        struct CullBuffers
+        {
+            std::vector<float> x;
+            std::vector<float> y;
+            std::vector<float> z;
+            std::vector<float> radius;
+            std::vector<uint8_t> visible;
+        };
+
+        ThreadBuffer& GetThreadBuffer();
+        void CullCommands(const std::vector<RenderCommand>& commands, const CameraData& cameraData);
+
+        template<typename T>
+        void MergeThreadBuffers(OrderedCommands<T> ThreadBuffer::* member, std::vector<T>& out);
+
+        // Stable LSD radix sort, equal keys keep the submit order
+        static void RadixSort(std::vector<SortItem>& items, std::vector<SortItem>& scratch);
+        static void BuildBatches(Frame& frame);
 
     private:
-        std::vector<RenderCommand> m_commands;
-        std::vector<RenderCommand2D> m_commands2D;
-        std::vector<RenderCommandUI> m_commandsUI;
+        std::vector<ThreadBuffer> m_threadBuffers;
+        std::array<Frame, 2> m_frames;
+        size_t m_frontFrame = 0;
         std::shared_ptr<Mesh> m_mesh2D;
+        GLuint m_instanceBuffer = 0;
+        RenderQueueStats m_stats;
+        CullBuffers m_cullBuffers;
+        bool m_cullingEnabled = true;
     };
 }
\ No newline at end of file
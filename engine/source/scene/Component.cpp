@@ -1,9 +1,23 @@
 #include "scene/Component.h"
+#include "scene/GameObject.h"
+#include "memory/PoolAllocator.h"
+
+#include <algorithm>
 
 namespace eng
 {
     size_t Component::nextId = 1;
 
+    void* Component::operator new(size_t size)
+    {
+        return ObjectPools::Allocate(size);
+    }
+
+    void Component::operator delete(void* ptr, size_t size)
+    {
+        ObjectPools::Deallocate(ptr, size);
+    }
+
     void Component::LoadProperties(const nlohmann::json& json)
     {
     }
@@ -21,12 +35,50 @@ namespace eng
         return m_owner;
     }
 
+    bool Component::IsOwnerActive() const
+    {
+        return m_owner && m_owner->IsAlive() && m_owner->IsActiveInHierarchy();
+    }
+
     ComponentFactory& ComponentFactory::GetInstance()
     {
         static ComponentFactory instance;
         return instance;
     }
 
+    void ComponentFactory::RegisterSystem(size_t typeId, UpdatePhase phase, SystemUpdateFunc func, SystemOrder order)
+    {
+        if (typeId >= m_systems.size())
+        {
+            m_systems.resize(typeId + 1);
+        }
+
+        m_systems[typeId].phase = phase;
+        m_systems[typeId].order = order;
+        m_systems[typeId].func = func;
+    }
+
+    UpdatePhase ComponentFactory::GetUpdatePhase(size_t typeId) const
+    {
+        return typeId < m_systems.size() ? m_systems[typeId].phase : UpdatePhase::Object;
+    }
+
+    SystemOrder ComponentFactory::GetSystemOrder(size_t typeId) const
+    {
+        return typeId < m_systems.size() ? m_systems[typeId].order : SystemOrder::Any;
+    }
+
+    SystemUpdateFunc ComponentFactory::GetSystemUpdateFunc(size_t typeId) const
+    {
+        return typeId < m_systems.size() ? m_systems[typeId].func : nullptr;
+    }
+
+    const std::string& ComponentFactory::GetTypeName(size_t typeId) const
+    {
+        static const std::string unknown = "Component";
+        return typeId < m_typeNames.size() && !m_typeNames[typeId].empty() ? m_typeNames[typeId] : unknown;
+    }
+
     Component* ComponentFactory::CreateComponent(const std::string& name)
     {
         auto it = m_creators.find(name);
@@ -40,26 +92,80 @@ namespace eng
 
     bool ComponentFactory::HasParent(size_t objectType, size_t parentType)
     {
-        auto record = m_parentMap.find(objectType);
-        if (record == m_parentMap.end())
+        if (objectType >= m_ancestors.size())
         {
             return false;
         }
 
-        auto& parents = record->second;
-        if (std::find(parents.begin(), parents.end(), parentType) != parents.end())
+        const auto& ancestors = m_ancestors[objectType];
+        return parentType < ancestors.size() && ancestors[parentType];
+    }
+
+    std::vector<size_t> ComponentFactory::GetParents(size_t objectType)
+    {
+        std::vector<size_t> result;
+        if (objectType >= m_ancestors.size())
+        {
+            return result;
+        }
+
+        const auto& ancestors = m_ancestors[objectType];
+        for (size_t type = 0; type < ancestors.size(); ++type)
         {
-            return true;
+            if (ancestors[type])
+            {
+                result.push_back(type);
+            }
         }
 
-        for (auto p : parents)
+        return result;
+    }
+
+    void ComponentFactory::AddParent(size_t objectType, size_t parentType)
+    {
+        const size_t size = std::max(objectType, parentType) + 1;
+        if (m_ancestors.size() < size)
+        {
+            m_ancestors.resize(size);
+        }
+        for (auto& row : m_ancestors)
         {
-            if (HasParent(p, parentType))
+            if (row.size() < m_ancestors.size())
             {
-                return true;
+                row.resize(m_ancestors.size(), false);
             }
         }
 
-        return false;
+        // The new ancestors are the parent and everything above it
+        std::vector<bool> added = m_ancestors[parentType];
+        added[parentType] = true;
+
+        // Registration order is free, so every type that already derives
+        // from objectType inherits the new ancestors as well
+        for (size_t type = 0; type < m_ancestors.size(); ++type)
+        {
+            auto& row = m_ancestors[type];
+            if (type != objectType && !row[objectType])
+            {
+                continue;
+            }
+
+            for (size_t i = 0; i < added.size(); ++i)
+            {
+                if (added[i])
+                {
+                    row[i] = true;
+                }
+            }
+        }
+    }
+
+    void ComponentFactory::AddTypeName(size_t typeId, const std::string& name)
+    {
+        if (typeId >= m_typeNames.size())
+        {
+            m_typeNames.resize(typeId + 1);
+        }
+        m_typeNames[typeId] = name;
     }
 }
\ No newline at end of file
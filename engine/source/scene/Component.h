@@ -6,21 +6,52 @@
 #include <string>
 #include <unordered_map>
 #include <memory>
+#include <type_traits>
+#include <vector>
 
 namespace eng
 {
     class GameObject;
 
+    // When the scene updates a component type
+    enum class UpdatePhase
+    {
+        // From the Update of the owner, in tree order
+        Object,
+        // Never, the type has no per-frame work
+        Never,
+        // In a per-type loop before the objects are updated
+        Early,
+        // In a per-type loop after the world transforms are final
+        Late
+    };
+
+    // Order of the components in the loop of their system
+    enum class SystemOrder
+    {
+        // Any order, the components do not depend on each other
+        Any,
+        // Same order as updating the objects one by one. For types that
+        // submit in order, like sprites and canvases.
+        Hierarchy
+    };
+
     class Component
     {
     public:
         virtual ~Component() = default;
+
+        static void* operator new(size_t size);
+        static void operator delete(void* ptr, size_t size);
+
         virtual void LoadProperties(const nlohmann::json& json);
         virtual void Update(float deltaTime);
         virtual void Init();
         virtual size_t GetTypeId() const = 0;
 
         GameObject* GetOwner();
+        // Owner is alive and it and all its ancestors are active
+        bool IsOwnerActive() const;
 
         template<typename T>
         static size_t StaticTypeId()
@@ -33,11 +64,35 @@ namespace eng
         GameObject* m_owner = nullptr;
 
         friend class GameObject;
+        friend class Scene;
 
     private:
+        static constexpr size_t NoSystemIndex = static_cast<size_t>(-1);
+
+        // Position in the system array of the scene
+        size_t m_systemIndex = NoSystemIndex;
+
         static size_t nextId;
     };
 
+    using SystemUpdateFunc = void(*)(Component* const* components, size_t count, float deltaTime);
+
+    // Update loop of a system type. T has to be final, so the compiler can
+    // bind the Update call at compile time without skipping an override.
+    template<typename T>
+    void UpdateComponentSystem(Component* const* components, size_t count, float deltaTime)
+    {
+        static_assert(std::is_final_v<T>, "Components with a system have to be final");
+        for (size_t i = 0; i < count; ++i)
+        {
+            Component* component = components[i];
+            if (component && component->IsOwnerActive())
+            {
+                static_cast<T*>(component)->Update(deltaTime);
+            }
+        }
+    }
+
     class ComponentCreatorBase
     {
     public:
@@ -64,22 +119,49 @@ namespace eng
         void RegisterComponent(const std::string& name)
         {
             m_creators.emplace(name, std::make_unique<ComponentCreator<T>>());
-            m_parentMap[T::TypeId()].push_back(Component::StaticTypeId<Component>());
+            AddTypeName(T::TypeId(), name);
+            AddParent(T::TypeId(), Component::StaticTypeId<Component>());
         }
 
         template<typename T, typename ParentType>
         void RegisterComponent(const std::string& name)
         {
             m_creators.emplace(name, std::make_unique<ComponentCreator<T>>());
-            m_parentMap[T::TypeId()].push_back(Component::StaticTypeId<ParentType>());
+            AddTypeName(T::TypeId(), name);
+            AddParent(T::TypeId(), Component::StaticTypeId<ParentType>());
         }
 
+        void RegisterSystem(size_t typeId, UpdatePhase phase, SystemUpdateFunc func, SystemOrder order = SystemOrder::Any);
+        UpdatePhase GetUpdatePhase(size_t typeId) const;
+        SystemOrder GetSystemOrder(size_t typeId) const;
+        SystemUpdateFunc GetSystemUpdateFunc(size_t typeId) const;
+        // Registered name, "Component" for types that were not registered
+        const std::string& GetTypeName(size_t typeId) const;
+
         Component* CreateComponent(const std::string& name);
         bool HasParent(size_t objectType, size_t parentType);
+        // All direct and indirect parent types of the given type
+        std::vector<size_t> GetParents(size_t objectType);
+
+    private:
+        void AddParent(size_t objectType, size_t parentType);
+        void AddTypeName(size_t typeId, const std::string& name);
 
     private:
         std::unordered_map<std::string, std::unique_ptr<ComponentCreatorBase>> m_creators;
-        std::unordered_map<size_t, std::vector<size_t>> m_parentMap;
+        // Indexed by type id
+        std::vector<std::string> m_typeNames;
+        // Row per type id, with a bit set for every direct or indirect parent
+        std::vector<std::vector<bool>> m_ancestors;
+
+        struct SystemInfo
+        {
+            UpdatePhase phase = UpdatePhase::Object;
+            SystemOrder order = SystemOrder::Any;
+            SystemUpdateFunc func = nullptr;
+        };
+        // Indexed by type id
+        std::vector<SystemInfo> m_systems;
     };
 
 #define COMPONENT(ComponentClass) \
@@ -88,6 +170,22 @@ public: \
     size_t GetTypeId() const override { return TypeId(); } \
     static void Register() { eng::ComponentFactory::GetInstance().RegisterComponent<ComponentClass>(std::string(#ComponentClass)); }
 
+// Component updated by the scene in a per-type loop, see UpdatePhase. The
+// class has to be final.
+#define COMPONENT_SYSTEM(ComponentClass, Phase) \
+    COMPONENT_SYSTEM_ORDERED(ComponentClass, Phase, eng::SystemOrder::Any)
+
+// Same, with the loop order given, see SystemOrder
+#define COMPONENT_SYSTEM_ORDERED(ComponentClass, Phase, Order) \
+public: \
+    static size_t TypeId() { return eng::Component::StaticTypeId<ComponentClass>(); } \
+    size_t GetTypeId() const override { return TypeId(); } \
+    static void Register() \
+    { \
+        eng::ComponentFactory::GetInstance().RegisterComponent<ComponentClass>(std::string(#ComponentClass)); \
+        eng::ComponentFactory::GetInstance().RegisterSystem(TypeId(), Phase, &eng::UpdateComponentSystem<ComponentClass>, Order); \
+    }
+
 #define COMPONENT_2(ComponentClass, ParentComponentClass) \
 public: \
     static size_t TypeId() { return eng::Component::StaticTypeId<ComponentClass>(); } \
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+namespace eng
+{
+    // Weak reference to a GameObject of a scene. The index points into the
+    // entity table of the scene and the generation tells whether the slot
+    // still holds the same object, so a handle to a destroyed object never
+    // resolves to whatever reused its slot.
+    struct EntityHandle
+    {
+        static constexpr uint32_t InvalidIndex = 0xFFFFFFFF;
+
+        uint32_t index = InvalidIndex;
+        uint32_t generation = 0;
+
+        bool IsNull() const
+        {
+            return index == InvalidIndex;
+        }
+
+        bool operator==(const EntityHandle& other) const
+        {
+            return index == other.index && generation == other.generation;
+        }
+
+        bool operator!=(const EntityHandle& other) const
+        {
+            return !(*this == other);
+        }
+    };
+}
+
+template<>
+struct std::hash<eng::EntityHandle>
+{
+    size_t operator()(const eng::EntityHandle& handle) const
+    {
+        return std::hash<uint64_t>()((static_cast<uint64_t>(handle.generation) << 32) | handle.index);
+    }
+};
\ No newline at end of file
@@ -6,6 +6,9 @@
 #include "render/Mesh.h"
 #include "scene/components/MeshComponent.h"
 #include "scene/components/AnimationComponent.h"
+#include "memory/PoolAllocator.h"
+#include "profiling/Profiler.h"
+#include "profiling/CostAccounting.h"
 
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/glm.hpp>
@@ -18,6 +21,42 @@
 
 namespace eng
 {
+    size_t GameObject::nextTypeId = 1;
+
+    GameObject::~GameObject()
+    {
+        if (m_scene)
+        {
+            for (auto& component : m_components)
+            {
+                m_scene->RemoveFromSystem(component.get());
+            }
+            m_scene->UnregisterName(this);
+            m_scene->ReleaseEntity(this);
+            m_scene->GetTransformStore().Destroy(m_transformId);
+        }
+    }
+
+    void* GameObject::operator new(size_t size)
+    {
+        return ObjectPools::Allocate(size);
+    }
+
+    void GameObject::operator delete(void* ptr, size_t size)
+    {
+        ObjectPools::Deallocate(ptr, size);
+    }
+
+    void* GameObject::PendingTransform::operator new(size_t size)
+    {
+        return ObjectPools::Allocate(size);
+    }
+
+    void GameObject::PendingTransform::operator delete(void* ptr, size_t size)
+    {
+        ObjectPools::Deallocate(ptr, size);
+    }
+
     void GameObject::Init()
     {
     }
@@ -33,25 +72,47 @@ namespace eng
             return;
         }
 
-        for (auto& component : m_components)
+        // Runs for every object, so the scopes are skipped as a whole when
+        // the accounting is off
+        auto& costs = Engine::GetInstance().GetCostAccounting();
+        if (!costs.IsEnabled())
+        {
+            for (auto component : m_updateComponents)
+            {
+                component->Update(deltaTime);
+            }
+
+            for (size_t i = 0; i < m_children.size(); ++i)
+            {
+                if (m_children[i]->IsAlive())
+                {
+                    m_children[i]->Update(deltaTime);
+                }
+            }
+            return;
+        }
+
+        for (auto component : m_updateComponents)
         {
+            CostScope scope(costs, CostAccounting::Category::Component, component->GetTypeId());
             component->Update(deltaTime);
         }
 
-        for (auto it = m_children.begin(); it != m_children.end();)
+        for (size_t i = 0; i < m_children.size(); ++i)
         {
-            if ((*it)->IsAlive())
+            if (m_children[i]->IsAlive())
             {
-                (*it)->Update(deltaTime);
-                ++it;
-            }
-            else
-            {
-                it = m_children.erase(it);
+                CostScope scope(costs, CostAccounting::Category::Object, m_children[i]->GetTypeId());
+                m_children[i]->Update(deltaTime);
             }
         }
     }
 
+    size_t GameObject::GetTypeId() const
+    {
+        return StaticTypeId<GameObject>();
+    }
+
     const std::string& GameObject::GetName() const
     {
         return m_name;
@@ -59,7 +120,16 @@ namespace eng
 
     void GameObject::SetName(const std::string& name)
     {
-        m_name = name;
+        if (m_scene)
+        {
+            m_scene->UnregisterName(this);
+            m_name = name;
+            m_scene->RegisterName(this);
+        }
+        else
+        {
+            m_name = name;
+        }
     }
 
     GameObject* GameObject::GetParent()
@@ -82,6 +152,11 @@ namespace eng
         return m_scene;
     }
 
+    EntityHandle GameObject::GetHandle() const
+    {
+        return m_handle;
+    }
+
     bool GameObject::IsAlive() const
     {
         return m_isAlive;
@@ -89,12 +164,27 @@ namespace eng
 
     void GameObject::MarkForDestroy()
     {
+        if (!m_isAlive)
+        {
+            return;
+        }
+
         m_isAlive = false;
+        if (m_scene)
+        {
+            m_scene->QueueDestroy(this);
+        }
     }
 
     void GameObject::SetActive(bool active)
     {
+        if (m_active == active)
+        {
+            return;
+        }
+
         m_active = active;
+        UpdateActiveInHierarchy();
     }
 
     bool GameObject::IsActive() const
@@ -102,6 +192,27 @@ namespace eng
         return m_active;
     }
 
+    bool GameObject::IsActiveInHierarchy() const
+    {
+        return m_activeInHierarchy;
+    }
+
+    void GameObject::UpdateActiveInHierarchy()
+    {
+        const bool active = m_active && (!m_parent || m_parent->m_activeInHierarchy);
+        if (active == m_activeInHierarchy)
+        {
+            return;
+        }
+
+        // Children below an unchanged object keep their state as well
+        m_activeInHierarchy = active;
+        for (auto& child : m_children)
+        {
+            child->UpdateActiveInHierarchy();
+        }
+    }
+
     void GameObject::AddComponent(Component* component)
     {
         if (!component)
@@ -109,12 +220,47 @@ namespace eng
             return;
         }
         m_components.emplace_back(component);
+        AddComponentSlot(component->GetTypeId(), component);
+        for (auto parentType : ComponentFactory::GetInstance().GetParents(component->GetTypeId()))
+        {
+            AddComponentSlot(parentType, component);
+        }
         component->m_owner = this;
+
+        const auto phase = ComponentFactory::GetInstance().GetUpdatePhase(component->GetTypeId());
+        if (phase == UpdatePhase::Object || !m_scene)
+        {
+            m_updateComponents.push_back(component);
+        }
+        else if (phase != UpdatePhase::Never)
+        {
+            m_scene->AddToSystem(component);
+        }
+
         component->Init();
     }
 
+    void GameObject::AddComponentSlot(size_t typeId, Component* component)
+    {
+        if (typeId >= m_componentSlots.size())
+        {
+            m_componentSlots.resize(typeId + 1, nullptr);
+        }
+
+        // Keep the first match, same as the order of m_components
+        if (!m_componentSlots[typeId])
+        {
+            m_componentSlots[typeId] = component;
+        }
+    }
+
     GameObject* GameObject::FindChildByName(const std::string& name)
     {
+        if (m_scene)
+        {
+            return m_scene->FindObjectByName(name, this);
+        }
+
         if (m_name == name)
         {
             return this;
@@ -138,7 +284,11 @@ namespace eng
 
     const glm::vec3& GameObject::GetPosition() const
     {
-        return m_position;
+        if (m_pendingTransform)
+        {
+            return m_pendingTransform->position;
+        }
+        return m_scene->GetTransformStore().GetPosition(m_transformId);
     }
 
     glm::vec3 GameObject::GetWorldPosition() const
@@ -149,7 +299,7 @@ namespace eng
 
     glm::vec2 GameObject::GetPosition2D() const
     {
-        return glm::vec2(m_position);
+        return glm::vec2(GetPosition());
     }
 
     glm::vec2 GameObject::GetWorldPosition2D() const
@@ -160,7 +310,13 @@ namespace eng
 
     void GameObject::SetPosition(const glm::vec3& pos)
     {
-        m_position = pos;
+        if (m_pendingTransform)
+        {
+            m_pendingTransform->position = pos;
+            return;
+        }
+        m_scene->GetTransformStore().SetPosition(m_transformId, pos);
+        MarkTransformDirty();
     }
 
     void GameObject::SetWorldPosition(const glm::vec3& pos)
@@ -180,34 +336,44 @@ namespace eng
 
     void GameObject::SetPosition2D(const glm::vec2& pos)
     {
-        m_position = glm::vec3(pos, 0.0f);
+        SetPosition(glm::vec3(pos, 0.0f));
     }
 
     const glm::quat& GameObject::GetRotation() const
     {
-        return m_rotation;
+        if (m_pendingTransform)
+        {
+            return m_pendingTransform->rotation;
+        }
+        return m_scene->GetTransformStore().GetRotation(m_transformId);
     }
 
     glm::quat GameObject::GetWorldRotation()
     {
         if (m_parent)
         {
-            return m_parent->GetWorldRotation() * m_rotation;
+            return m_parent->GetWorldRotation() * GetRotation();
         }
         else
         {
-            return m_rotation;
+            return GetRotation();
         }
     }
 
     float GameObject::GetRotation2D() const
     {
-        return glm::angle(m_rotation);
+        return glm::angle(GetRotation());
     }
 
     void GameObject::SetRotation(const glm::quat& rot)
     {
-        m_rotation = rot;
+        if (m_pendingTransform)
+        {
+            m_pendingTransform->rotation = rot;
+            return;
+        }
+        m_scene->GetTransformStore().SetRotation(m_transformId, rot);
+        MarkTransformDirty();
     }
 
     void GameObject::SetWorldRotation(const glm::quat& rot)
@@ -227,84 +393,107 @@ namespace eng
 
     void GameObject::SetRotation2D(float rotation)
     {
-        m_rotation = glm::angleAxis(rotation, glm::vec3(0.0f, 0.0f, 1.0f));
+        SetRotation(glm::angleAxis(rotation, glm::vec3(0.0f, 0.0f, 1.0f)));
     }
 
     const glm::vec3& GameObject::GetScale() const
     {
-        return m_scale;
+        if (m_pendingTransform)
+        {
+            return m_pendingTransform->scale;
+        }
+        return m_scene->GetTransformStore().GetScale(m_transformId);
     }
 
     glm::vec2 GameObject::GetScale2D() const
     {
-        return glm::vec2(m_scale);
+        return glm::vec2(GetScale());
     }
 
     void GameObject::SetScale(const glm::vec3& scale)
     {
-        m_scale = scale;
+        if (m_pendingTransform)
+        {
+            m_pendingTransform->scale = scale;
+            return;
+        }
+        m_scene->GetTransformStore().SetScale(m_transformId, scale);
+        MarkTransformDirty();
     }
 
     void GameObject::SetScale2D(const glm::vec2& scale)
     {
-        m_scale = glm::vec3(scale, 1.0f);
+        SetScale(glm::vec3(scale, 1.0f));
     }
 
     glm::mat4 GameObject::GetLocalTransform() const
     {
-        glm::mat4 mat = glm::mat4(1.0f);
-
-        // Translation
-        mat = glm::translate(mat, m_position);
-
-        // Rotation
-        mat = mat * glm::mat4_cast(m_rotation);
-
-        // Scale
-        mat = glm::scale(mat, m_scale);
-
-        return mat;
+        if (m_pendingTransform)
+        {
+            return TransformStore::Compose(m_pendingTransform->position, m_pendingTransform->rotation, m_pendingTransform->scale);
+        }
+        return m_scene->GetTransformStore().GetLocalTransform(m_transformId);
     }
 
     glm::mat4 GameObject::GetLocalTransform2D() const
     {
-        glm::mat4 mat = glm::mat4(1.0f);
-
-        const auto rotationZ = GetRotation2D();
-        float c = cos(rotationZ);
-        float s = sin(rotationZ);
-
-        mat[0][0] = m_scale.x * c;
-        mat[0][1] = m_scale.x * s;
-        mat[1][0] = -m_scale.y * s;
-        mat[1][1] = m_scale.y * c;
-        mat[3][0] = m_position.x;
-        mat[3][1] = m_position.y;
-
-        return mat;
+        if (m_pendingTransform)
+        {
+            return TransformStore::Compose2D(m_pendingTransform->position, m_pendingTransform->rotation, m_pendingTransform->scale);
+        }
+        return m_scene->GetTransformStore().GetLocalTransform2D(m_transformId);
     }
 
     glm::mat4 GameObject::GetWorldTransform() const
     {
-        if (m_parent)
-        {
-            return m_parent->GetWorldTransform() * GetLocalTransform();
-        }
-        else
+        // A pending object is not attached yet, so world equals local
+        if (m_pendingTransform)
         {
             return GetLocalTransform();
         }
+        return m_scene->GetTransformStore().GetWorldTransform(m_transformId);
     }
 
     glm::mat4 GameObject::GetWorldTransform2D() const
     {
-        if (m_parent)
+        if (m_pendingTransform)
         {
-            return m_parent->GetWorldTransform2D() * GetLocalTransform2D();
+            return GetLocalTransform2D();
         }
-        else
+        return m_scene->GetTransformStore().GetWorldTransform2D(m_transformId);
+    }
+
+    glm::mat4 GameObject::GetInterpolatedWorldTransform(float alpha) const
+    {
+        if (m_pendingTransform)
         {
-            return GetLocalTransform2D();
+            return GetWorldTransform();
+        }
+        return m_scene->GetTransformStore().GetInterpolatedWorldTransform(m_transformId, alpha);
+    }
+
+    uint32_t GameObject::GetTransformId() const
+    {
+        return m_transformId;
+    }
+
+    void GameObject::MarkTransformDirty()
+    {
+        if (m_pendingTransform)
+        {
+            return;
+        }
+
+        // A clean object never has a dirty ancestor, so if this one is
+        // already dirty the whole subtree below it is dirty as well
+        if (!m_scene->GetTransformStore().MarkDirty(m_transformId))
+        {
+            return;
+        }
+
+        for (auto& child : m_children)
+        {
+            child->MarkTransformDirty();
         }
     }
 
@@ -573,6 +762,7 @@ namespace eng
 
     GameObject* GameObject::LoadGLTF(const std::string& path, Scene* gameScene)
     {
+        ENG_PROFILE_SCOPE("GameObject::LoadGLTF");
         auto contents = Engine::GetInstance().GetFileSystem().LoadAssetFileText(path);
         if (contents.empty())
         {
@@ -734,4 +924,10 @@ namespace eng
 
         return it->second->CreateGameObject();
     }
+
+    const std::string& GameObjectFactory::GetTypeName(size_t typeId) const
+    {
+        static const std::string unknown = "GameObject";
+        return typeId < m_typeNames.size() && !m_typeNames[typeId].empty() ? m_typeNames[typeId] : unknown;
+    }
 }
\ No newline at end of file
@@ -1,8 +1,11 @@
 #pragma once
 #include "scene/Component.h"
+#include "scene/TransformStore.h"
+#include "scene/EntityHandle.h"
 #include <string>
 #include <vector>
 #include <memory>
+#include <limits>
 #include <glm/vec3.hpp>
 #include <glm/gtc/quaternion.hpp>
 #include <glm/mat4x4.hpp>
@@ -14,34 +17,39 @@ namespace eng
     class GameObject
     {
     public:
-        virtual ~GameObject() = default;
+        virtual ~GameObject();
+
+        static void* operator new(size_t size);
+        static void operator delete(void* ptr, size_t size);
+
         virtual void Init();
         virtual void LoadProperties(const nlohmann::json& json);
         virtual void Update(float deltaTime);
+        // Set by the GAMEOBJECT macro, plain objects share the base id
+        virtual size_t GetTypeId() const;
         const std::string& GetName() const;
         void SetName(const std::string& name);
         GameObject* GetParent();
         bool SetParent(GameObject* parent);
         Scene* GetScene();
+        EntityHandle GetHandle() const;
         bool IsAlive() const;
         void MarkForDestroy();
 
         void SetActive(bool active);
         bool IsActive() const;
+        // Active and so are all the ancestors. Cached, updated by SetActive
+        // and on reparenting.
+        bool IsActiveInHierarchy() const;
 
         void AddComponent(Component* component);
         template<typename T, typename = typename std::enable_if_t<std::is_base_of_v<Component, T>>>
         T* GetComponent()
         {
             size_t typeId = Component::StaticTypeId<T>();
-
-            for (auto& component : m_components)
+            if (typeId < m_componentSlots.size())
             {
-                if (component->GetTypeId() == typeId ||
-                    ComponentFactory::GetInstance().HasParent(component->GetTypeId(), typeId))
-                {
-                    return static_cast<T*>(component.get());
-                }
+                return static_cast<T*>(m_componentSlots[typeId]);
             }
 
             return nullptr;
@@ -74,23 +82,69 @@ namespace eng
         glm::mat4 GetLocalTransform2D() const;
         glm::mat4 GetWorldTransform() const;
         glm::mat4 GetWorldTransform2D() const;
+        // World transform between the last two fixed steps, for rendering
+        glm::mat4 GetInterpolatedWorldTransform(float alpha) const;
+        uint32_t GetTransformId() const;
 
         static GameObject* LoadGLTF(const std::string& path, Scene* scene);
 
+        template<typename T>
+        static size_t StaticTypeId()
+        {
+            static size_t typeId = nextTypeId++;
+            return typeId;
+        }
+
     protected:
         GameObject() = default;
 
+    private:
+        // Transform of an object created during a scene update, moved to
+        // the TransformStore once the update is over
+        struct PendingTransform
+        {
+            glm::vec3 position = glm::vec3(0.0f);
+            glm::quat rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+            glm::vec3 scale = glm::vec3(1.0f);
+
+            static void* operator new(size_t size);
+            static void operator delete(void* ptr, size_t size);
+        };
+
+        static constexpr size_t NoSiblingIndex = std::numeric_limits<size_t>::max();
+
+        void MarkTransformDirty();
+        void UpdateActiveInHierarchy();
+        void AddComponentSlot(size_t typeId, Component* component);
+
+        static size_t nextTypeId;
+
     protected:
         std::string m_name;
         GameObject* m_parent = nullptr;
         Scene* m_scene = nullptr;
+        EntityHandle m_handle;
         std::vector<std::unique_ptr<GameObject>> m_children;
+        // Index in m_children of the parent, or in the root list of the scene
+        size_t m_siblingIndex = NoSiblingIndex;
+        // Depth first position in the scene, the update order of systems.
+        // The subtree of the object spans [m_hierarchyOrder, m_hierarchyEnd).
+        uint32_t m_hierarchyOrder = 0;
+        uint32_t m_hierarchyEnd = 0;
         std::vector<std::unique_ptr<Component>> m_components;
+        // Indexed by component type id. Holds the first added component of
+        // that type or of any type derived from it.
+        std::vector<Component*> m_componentSlots;
+        // Components with UpdatePhase::Object, the rest is updated by the scene
+        std::vector<Component*> m_updateComponents;
         bool m_isAlive = true;
-        glm::vec3 m_position = glm::vec3(0.0f);
-        glm::quat m_rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
-        glm::vec3 m_scale = glm::vec3(1.0f);
         bool m_active = true;
+        bool m_activeInHierarchy = true;
+
+        // Position, rotation, scale and the cached world matrices live in
+        // the TransformStore of the owning scene
+        uint32_t m_transformId = TransformStore::InvalidIndex;
+        std::unique_ptr<PendingTransform> m_pendingTransform;
 
         friend class Scene;
     };
@@ -120,15 +174,26 @@ namespace eng
         void RegisterObject(const std::string& name)
         {
             m_creators.emplace(name, std::make_unique<ObjectCreator<T>>());
+            if (T::TypeId() >= m_typeNames.size())
+            {
+                m_typeNames.resize(T::TypeId() + 1);
+            }
+            m_typeNames[T::TypeId()] = name;
         }
 
         GameObject* CreateGameObject(const std::string& typeName);
+        // Registered name, "GameObject" for plain and unregistered types
+        const std::string& GetTypeName(size_t typeId) const;
 
     private:
         std::unordered_map<std::string, std::unique_ptr<ObjectCreatorBase>> m_creators;
+        // Indexed by type id
+        std::vector<std::string> m_typeNames;
     };
 
 #define GAMEOBJECT(ObjectClass) \
 public: \
+    static size_t TypeId() { return eng::GameObject::StaticTypeId<ObjectClass>(); } \
+    size_t GetTypeId() const override { return TypeId(); } \
     static void Register() { eng::GameObjectFactory::GetInstance().RegisterObject<ObjectClass>(std::string(#ObjectClass)); }
 }
\ No newline at end of file
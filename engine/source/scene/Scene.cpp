@@ -11,9 +11,16 @@
 #include "scene/components/ui/UIElementComponent.h"
 #include "scene/components/ui/CanvasComponent.h"
 #include "scene/components/ui/TextComponent.h"
+#include "scene/components/ui/FrameStatsComponent.h"
 #include "scene/components/ui/ButtonComponent.h"
 #include "scene/components/ui/RectTransformComponent.h"
 #include "Engine.h"
+#include "profiling/Profiler.h"
+#include "profiling/CostAccounting.h"
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
 
 namespace eng
 {
@@ -31,58 +38,127 @@ namespace eng
         UIElementComponent::Register();
         CanvasComponent::Register();
         TextComponent::Register();
+        FrameStatsComponent::Register();
         ButtonComponent::Register();
         RectTransformComponent::Register();
     }
 
     void Scene::Update(float deltaTime)
     {
-        m_objects.erase(
-            std::remove_if(m_objects.begin(), m_objects.end(),
-                [](const std::unique_ptr<GameObject>& obj) { return !obj->IsAlive(); }),
-            m_objects.end()
-        );
-
-        for (auto& obj : m_objectsToAdd)
+        ENG_PROFILE_SCOPE("Scene::Update");
+        // Rendering blends from the transforms at the start of the step
+        if (Engine::GetInstance().GetFixedTimestep() > 0.0f)
         {
-            SetParent(obj.first, obj.second);
+            m_transforms.StorePreviousWorldTransforms();
         }
-        m_objectsToAdd.clear();
+
+        // Removals since the last update leave null slots
+        CompactSystems();
+        SortSystems();
 
         m_isUpdating = true;
-        for (auto it = m_objects.begin(); it != m_objects.end();)
+        RunSystems(UpdatePhase::Early, deltaTime);
+
+        auto& jobSystem = Engine::GetInstance().GetJobSystem();
+        auto& costs = Engine::GetInstance().GetCostAccounting();
+        if (m_parallelUpdate && jobSystem.GetThreadCount() > 1)
+        {
+            // Objects read transforms outside their own subtree, like the
+            // camera or the player. Everything is clean when the workers
+            // start, and what they move in the meantime is read without
+            // caching.
+            m_transforms.UpdateWorldTransforms();
+            m_transforms.SetConcurrentReads(true);
+            jobSystem.ParallelFor(m_objects.size(), [this, deltaTime, &costs](size_t i)
+                {
+                    // Keeps the draw order the same as in a serial update
+                    RenderQueue::SetSubmitOrder(static_cast<uint32_t>(i));
+                    if (m_objects[i]->IsAlive())
+                    {
+                        CostScope scope(costs, CostAccounting::Category::Object, m_objects[i]->GetTypeId());
+                        m_objects[i]->Update(deltaTime);
+                    }
+                });
+            m_transforms.SetConcurrentReads(false);
+            RenderQueue::SetSubmitOrder(0);
+        }
+        else
         {
-            if ((*it)->IsAlive())
+            for (size_t i = 0; i < m_objects.size(); ++i)
             {
-                (*it)->Update(deltaTime);
-                ++it;
+                if (m_objects[i]->IsAlive())
+                {
+                    CostScope scope(costs, CostAccounting::Category::Object, m_objects[i]->GetTypeId());
+                    m_objects[i]->Update(deltaTime);
+                }
             }
-            else
+        }
+        m_isUpdating = false;
+
+        // Structural changes requested during the update are applied here.
+        // Transforms first, so parents created in the same frame have one.
+        auto objectsToAdd = std::move(m_objectsToAdd);
+        m_objectsToAdd.clear();
+        m_pendingParents.clear();
+        for (auto& obj : objectsToAdd)
+        {
+            CommitEntity(obj.first);
+            CommitTransform(obj.first);
+        }
+        for (auto& obj : objectsToAdd)
+        {
+            // Checked when queued, but an earlier change in the queue can
+            // have made it a cycle since
+            if (!SetParent(obj.first, obj.second))
             {
-                it = m_objects.erase(it);
+                std::cerr << "Scene: could not move " << obj.first->GetName() << " under "
+                    << (obj.second ? obj.second->GetName() : std::string("the root")) << std::endl;
+
+                // A new object would have no owner, it goes to the root
+                if (obj.first->m_siblingIndex == GameObject::NoSiblingIndex)
+                {
+                    SetParent(obj.first, nullptr);
+                }
             }
         }
+        for (auto component : m_systemsToAdd)
+        {
+            InsertIntoSystem(component);
+        }
+        m_systemsToAdd.clear();
+
+        DestroyQueuedObjects();
+        CompactSystems();
+        SortSystems();
+
+        m_transforms.UpdateWorldTransforms();
+    }
+
+    void Scene::LateUpdate(float deltaTime)
+    {
+        ENG_PROFILE_SCOPE("Scene::LateUpdate");
+        // Anything created by the late systems is picked up next update
+        m_isUpdating = true;
+        RunSystems(UpdatePhase::Late, deltaTime);
         m_isUpdating = false;
     }
 
     void Scene::Clear()
     {
+        m_systemsToAdd.clear();
+        m_destroyQueue.clear();
+        m_destroyedObjects.clear();
         m_objects.clear();
     }
 
     GameObject* Scene::CreateObject(const std::string& name, GameObject* parent)
     {
         auto obj = new GameObject();
-        obj->SetName(name);
         obj->m_scene = this;
-        if (m_isUpdating)
-        {
-            m_objectsToAdd.push_back({ obj, parent });
-        }
-        else
-        {
-            SetParent(obj, parent);
-        }
+        InitEntity(obj);
+        InitTransform(obj);
+        obj->SetName(name);
+        SetParent(obj, parent);
         return obj;
     }
 
@@ -91,176 +167,568 @@ namespace eng
         auto obj = GameObjectFactory::GetInstance().CreateGameObject(type);
         if (obj)
         {
-            obj->SetName(name);
             obj->m_scene = this;
-            if (m_isUpdating)
+            InitEntity(obj);
+            InitTransform(obj);
+            obj->SetName(name);
+            SetParent(obj, parent);
+        }
+        return obj;
+    }
+
+    bool Scene::SetParent(GameObject* obj, GameObject* parent)
+    {
+        // The update walks the sibling lists, so they only change after it
+        if (m_isUpdating)
+        {
+            std::lock_guard<std::mutex> lock(m_structureMutex);
+            if (!CanSetParent(obj, parent))
             {
-                m_objectsToAdd.push_back({ obj, parent });
+                return false;
             }
-            else
+            m_objectsToAdd.push_back({ obj, parent });
+            m_pendingParents[obj] = parent;
+            return true;
+        }
+
+        if (!CanSetParent(obj, parent))
+        {
+            return false;
+        }
+
+        // Objects that have been just created are not in the hierarchy yet
+        const bool inHierarchy = obj->m_siblingIndex != GameObject::NoSiblingIndex;
+
+        std::unique_ptr<GameObject> objHolder;
+        if (inHierarchy)
+        {
+            objHolder = DetachObject(obj);
+        }
+        else
+        {
+            objHolder.reset(obj);
+        }
+
+        auto& siblings = parent ? parent->m_children : m_objects;
+        obj->m_siblingIndex = siblings.size();
+        siblings.push_back(std::move(objHolder));
+        m_hierarchyOrderDirty = true;
+        obj->m_parent = parent;
+        m_transforms.SetParent(obj->m_transformId, parent ? parent->m_transformId : TransformStore::InvalidIndex);
+        obj->MarkTransformDirty();
+        obj->UpdateActiveInHierarchy();
+        // A new object has no components in a system yet, adding them
+        // requests the sort if needed
+        if (inHierarchy)
+        {
+            m_systemsNeedSort = true;
+        }
+
+        return true;
+    }
+
+    bool Scene::CanSetParent(GameObject* obj, GameObject* parent) const
+    {
+        // Objects that have been just created are only in the hierarchy
+        // once their queued change is applied
+        bool queued = false;
+        auto pendingParent = GetPendingParent(obj, queued);
+        const bool inHierarchy = queued || obj->m_siblingIndex != GameObject::NoSiblingIndex;
+        if (inHierarchy && pendingParent == parent)
+        {
+            return false;
+        }
+
+        // Can't attach an object to itself or to one of its descendants
+        auto currentElement = parent;
+        while (currentElement)
+        {
+            if (currentElement == obj)
             {
-                SetParent(obj, parent);
+                return false;
             }
+            currentElement = GetPendingParent(currentElement, queued);
         }
-        return obj;
+
+        return true;
     }
 
-    bool Scene::SetParent(GameObject* obj, GameObject* parent)
+    GameObject* Scene::GetPendingParent(GameObject* obj, bool& queued) const
     {
-        bool result = false;
-        auto currentParent = obj->GetParent();
+        // Holds the last change queued during the update, the one that sticks
+        auto it = m_pendingParents.find(obj);
+        if (it != m_pendingParents.end())
+        {
+            queued = true;
+            return it->second;
+        }
+        return obj->GetParent();
+    }
 
-        if (parent == nullptr)
+    void Scene::AddToSystem(Component* component)
+    {
+        if (m_isUpdating)
         {
-            if (currentParent != nullptr)
-            {
-                auto it = std::find_if(
-                    currentParent->m_children.begin(),
-                    currentParent->m_children.end(),
-                    [obj](const std::unique_ptr<GameObject>& el) {
-                        return el.get() == obj;
-                    }
-                );
+            std::lock_guard<std::mutex> lock(m_structureMutex);
+            m_systemsToAdd.push_back(component);
+        }
+        else
+        {
+            InsertIntoSystem(component);
+        }
+    }
 
-                if (it != currentParent->m_children.end())
-                {
-                    m_objects.push_back(std::move(*it));
-                    obj->m_parent = nullptr;
-                    currentParent->m_children.erase(it);
-                    result = true;
-                }
-            }
-            // No parent currently. This can be in 2 cases
-            // 1. The object is in the scene root
-            // 2. The object has been just created
-            else
-            {
-                auto it = std::find_if(
-                    m_objects.begin(),
-                    m_objects.end(),
-                    [obj](const std::unique_ptr<GameObject>& el) {
-                        return el.get() == obj;
-                    }
-                );
+    void Scene::InsertIntoSystem(Component* component)
+    {
+        const size_t typeId = component->GetTypeId();
+        if (typeId >= m_systems.size())
+        {
+            m_systems.resize(typeId + 1);
+        }
+
+        auto& system = m_systems[typeId];
+        component->m_systemIndex = system.size();
+        system.push_back(component);
+        if (ComponentFactory::GetInstance().GetSystemOrder(typeId) == SystemOrder::Hierarchy)
+        {
+            m_systemsNeedSort = true;
+        }
+    }
 
-                if (it == m_objects.end())
+    void Scene::RemoveFromSystem(Component* component)
+    {
+        if (component->m_systemIndex == Component::NoSystemIndex)
+        {
+            return;
+        }
+
+        m_systems[component->GetTypeId()][component->m_systemIndex] = nullptr;
+        component->m_systemIndex = Component::NoSystemIndex;
+        m_systemsNeedCompaction = true;
+    }
+
+    void Scene::CompactSystems()
+    {
+        if (!m_systemsNeedCompaction)
+        {
+            return;
+        }
+
+        // Stable, so the submit order of sprites does not change
+        for (auto& system : m_systems)
+        {
+            size_t count = 0;
+            for (auto component : system)
+            {
+                if (component)
                 {
-                    std::unique_ptr<GameObject> objHolder(obj);
-                    m_objects.push_back(std::move(objHolder));
-                    result = true;
+                    component->m_systemIndex = count;
+                    system[count++] = component;
                 }
             }
+            system.resize(count);
         }
-        // We are trying to add it as a child of another object
-        else
+        m_systemsNeedCompaction = false;
+    }
+
+    void Scene::SortSystems()
+    {
+        if (!m_systemsNeedSort)
         {
-            if (currentParent != nullptr)
-            {
-                auto it = std::find_if(
-                    currentParent->m_children.begin(),
-                    currentParent->m_children.end(),
-                    [obj](const std::unique_ptr<GameObject>& el) {
-                        return el.get() == obj;
-                    }
-                );
+            return;
+        }
 
-                if (it != currentParent->m_children.end())
-                {
-                    bool found = false;
-                    auto currentElement = parent;
-                    while (currentElement)
-                    {
-                        if (currentElement == obj)
-                        {
-                            found = true;
-                            break;
-                        }
-                        currentElement = currentElement->GetParent();
-                    }
+        m_systemsNeedSort = false;
 
-                    if (!found)
-                    {
-                        parent->m_children.push_back(std::move(*it));
-                        obj->m_parent = parent;
-                        currentParent->m_children.erase(it);
-                        result = true;
-                    }
-                }
+        // Only the systems that submit in order are sorted, the tree is not
+        // walked if there are none
+        auto& factory = ComponentFactory::GetInstance();
+        bool hasOrderedSystems = false;
+        for (size_t typeId = 0; typeId < m_systems.size(); ++typeId)
+        {
+            if (!m_systems[typeId].empty() && factory.GetSystemOrder(typeId) == SystemOrder::Hierarchy)
+            {
+                hasOrderedSystems = true;
+                break;
             }
-            // No parent currently. This can be in 2 cases
-            // 1. The object is in the scene root
-            // 2. The object has been just created
-            else
+        }
+        if (!hasOrderedSystems)
+        {
+            return;
+        }
+
+        // Same order as updating the objects one by one
+        UpdateHierarchyOrder();
+
+        for (size_t typeId = 0; typeId < m_systems.size(); ++typeId)
+        {
+            auto& system = m_systems[typeId];
+            if (factory.GetSystemOrder(typeId) != SystemOrder::Hierarchy)
             {
-                auto it = std::find_if(
-                    m_objects.begin(),
-                    m_objects.end(),
-                    [obj](const std::unique_ptr<GameObject>& el) {
-                        return el.get() == obj;
-                    }
-                );
+                continue;
+            }
 
-                // The object has been hust created
-                if (it == m_objects.end())
+            std::stable_sort(system.begin(), system.end(), [](Component* a, Component* b)
                 {
-                    std::unique_ptr<GameObject> objHolder(obj);
-                    parent->m_children.push_back(std::move(objHolder));
-                    obj->m_parent = parent;
-                    result = true;
-                }
-                else
-                {
-                    bool found = false;
-                    auto currentElement = parent;
-                    while (currentElement)
-                    {
-                        if (currentElement == obj)
-                        {
-                            found = true;
-                            break;
-                        }
-                        currentElement = currentElement->GetParent();
-                    }
+                    return a->GetOwner()->m_hierarchyOrder < b->GetOwner()->m_hierarchyOrder;
+                });
+            for (size_t i = 0; i < system.size(); ++i)
+            {
+                system[i]->m_systemIndex = i;
+            }
+        }
+    }
 
-                    if (!found)
-                    {
-                        parent->m_children.push_back(std::move(*it));
-                        obj->m_parent = parent;
-                        m_objects.erase(it);
-                        result = true;
-                    }
-                }
+    void Scene::UpdateHierarchyOrder()
+    {
+        if (!m_hierarchyOrderDirty)
+        {
+            return;
+        }
+
+        uint32_t order = 0;
+        for (auto& obj : m_objects)
+        {
+            AssignHierarchyOrder(obj.get(), order);
+        }
+        m_hierarchyOrderDirty = false;
+    }
+
+    void Scene::AssignHierarchyOrder(GameObject* obj, uint32_t& order)
+    {
+        obj->m_hierarchyOrder = order++;
+        for (auto& child : obj->m_children)
+        {
+            AssignHierarchyOrder(child.get(), order);
+        }
+        obj->m_hierarchyEnd = order;
+    }
+
+    void Scene::RunSystems(UpdatePhase phase, float deltaTime)
+    {
+        auto& factory = ComponentFactory::GetInstance();
+        auto& costs = Engine::GetInstance().GetCostAccounting();
+        for (size_t typeId = 0; typeId < m_systems.size(); ++typeId)
+        {
+            const auto& system = m_systems[typeId];
+            if (system.empty() || factory.GetUpdatePhase(typeId) != phase)
+            {
+                continue;
             }
+
+            CostScope scope(costs, CostAccounting::Category::Component, typeId, system.size());
+            factory.GetSystemUpdateFunc(typeId)(system.data(), system.size(), deltaTime);
         }
+    }
 
-        return result;
+    void Scene::InitEntity(GameObject* obj)
+    {
+        std::lock_guard<std::mutex> lock(m_structureMutex);
+        uint32_t index = 0;
+        if (!m_freeEntities.empty())
+        {
+            index = m_freeEntities.back();
+            m_freeEntities.pop_back();
+        }
+        else
+        {
+            index = m_entityCount++;
+        }
+
+        obj->m_handle.index = index;
+        obj->m_handle.generation = index < m_entities.size() ? m_entities[index].generation : 0;
+
+        // Other threads may be resolving handles, so the table is only
+        // written once the update is over
+        if (!m_isUpdating)
+        {
+            m_entities.resize(m_entityCount);
+            m_entities[index].object = obj;
+        }
+    }
+
+    void Scene::CommitEntity(GameObject* obj)
+    {
+        m_entities.resize(m_entityCount);
+        m_entities[obj->m_handle.index].object = obj;
+    }
+
+    void Scene::ReleaseEntity(GameObject* obj)
+    {
+        if (obj->m_handle.IsNull())
+        {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(m_structureMutex);
+        m_entities.resize(m_entityCount);
+        auto& slot = m_entities[obj->m_handle.index];
+        slot.object = nullptr;
+        ++slot.generation;
+        m_freeEntities.push_back(obj->m_handle.index);
+        obj->m_handle = EntityHandle();
+    }
+
+    GameObject* Scene::Resolve(EntityHandle handle)
+    {
+        if (handle.index >= m_entities.size())
+        {
+            return nullptr;
+        }
+
+        const auto& slot = m_entities[handle.index];
+        if (slot.generation != handle.generation || !slot.object || !slot.object->IsAlive())
+        {
+            return nullptr;
+        }
+
+        return slot.object;
+    }
+
+    void Scene::InitTransform(GameObject* obj)
+    {
+        // Growing the store could move transforms that other threads are
+        // reading, so objects created during an update get a slot later
+        if (m_isUpdating)
+        {
+            obj->m_pendingTransform = std::make_unique<GameObject::PendingTransform>();
+        }
+        else
+        {
+            obj->m_transformId = m_transforms.Create();
+        }
+    }
+
+    void Scene::CommitTransform(GameObject* obj)
+    {
+        if (!obj->m_pendingTransform)
+        {
+            return;
+        }
+
+        auto pending = std::move(obj->m_pendingTransform);
+        obj->m_transformId = m_transforms.Create();
+        m_transforms.SetPosition(obj->m_transformId, pending->position);
+        m_transforms.SetRotation(obj->m_transformId, pending->rotation);
+        m_transforms.SetScale(obj->m_transformId, pending->scale);
+    }
+
+    std::unique_ptr<GameObject> Scene::DetachObject(GameObject* obj)
+    {
+        auto& siblings = obj->m_parent ? obj->m_parent->m_children : m_objects;
+        const size_t index = obj->m_siblingIndex;
+
+        // Swap with the last sibling and pop, so the order of siblings is
+        // not preserved
+        std::unique_ptr<GameObject> objHolder = std::move(siblings[index]);
+        if (index + 1 != siblings.size())
+        {
+            siblings[index] = std::move(siblings.back());
+            siblings[index]->m_siblingIndex = index;
+        }
+        siblings.pop_back();
+        m_hierarchyOrderDirty = true;
+
+        obj->m_parent = nullptr;
+        obj->m_siblingIndex = GameObject::NoSiblingIndex;
+        return objHolder;
     }
 
     GameObject* Scene::FindObjectByName(const std::string& name)
     {
-        for (auto& obj : m_objects)
+        return FindObjectByName(name, nullptr);
+    }
+
+    GameObject* Scene::FindObjectByName(const std::string& name, GameObject* root)
+    {
+        // Only a parallel update can change the index or the tree order
+        // from another thread
+        std::unique_lock<std::mutex> lock(m_structureMutex, std::defer_lock);
+        if (m_isUpdating)
+        {
+            lock.lock();
+        }
+
+        auto it = m_nameIndex.find(name);
+        if (it == m_nameIndex.end())
         {
-            if (auto child = obj->FindChildByName(name))
+            return nullptr;
+        }
+
+        // Objects created during an update are not in the tree until the
+        // update is over, only the root itself can match then
+        if (root && root->m_siblingIndex == GameObject::NoSiblingIndex)
+        {
+            return root->IsAlive() && root->GetName() == name ? root : nullptr;
+        }
+
+        // The tree does not change during an update, so this renumbers at
+        // most once per change to it
+        UpdateHierarchyOrder();
+        const uint32_t begin = root ? root->m_hierarchyOrder : 0;
+        const uint32_t end = root ? root->m_hierarchyEnd : std::numeric_limits<uint32_t>::max();
+
+        GameObject* result = nullptr;
+        for (auto obj : it->second)
+        {
+            // Dead objects stay in the index until they are deleted, which
+            // in a pipelined engine is after the next draw
+            if (!obj->IsAlive() || obj->m_siblingIndex == GameObject::NoSiblingIndex)
             {
-                return child;
+                continue;
             }
+
+            const uint32_t order = obj->m_hierarchyOrder;
+            if (order < begin || order >= end || (result && order >= result->m_hierarchyOrder))
+            {
+                continue;
+            }
+
+            result = obj;
         }
-        return nullptr;
+
+        return result;
     }
     
     void Scene::SetMainCamera(GameObject* camera)
     {
-        m_mainCamera = camera;
+        m_mainCamera = camera ? camera->GetHandle() : EntityHandle();
     }
 
     GameObject* Scene::GetMainCamera()
     {
-        return m_mainCamera;
+        return Resolve(m_mainCamera);
+    }
+
+    void Scene::QueueDestroy(GameObject* obj)
+    {
+        std::lock_guard<std::mutex> lock(m_structureMutex);
+        m_destroyQueue.push_back(obj);
+    }
+
+    void Scene::DestroyQueuedObjects()
+    {
+        ENG_PROFILE_SCOPE("Scene::DestroyQueuedObjects");
+        if (m_destroyQueue.empty())
+        {
+            return;
+        }
+
+        // Objects below another dead object go away together with it, so
+        // only the topmost ones are detached. This runs before anything is
+        // deleted, while every queued pointer is still valid.
+        size_t count = 0;
+        for (auto obj : m_destroyQueue)
+        {
+            bool deadAncestor = false;
+            for (auto current = obj->GetParent(); current; current = current->GetParent())
+            {
+                if (!current->IsAlive())
+                {
+                    deadAncestor = true;
+                    break;
+                }
+            }
+
+            if (!deadAncestor)
+            {
+                m_destroyQueue[count++] = obj;
+            }
+        }
+        m_destroyQueue.resize(count);
+
+        const bool keepObjects = Engine::GetInstance().IsPipelined();
+        for (auto obj : m_destroyQueue)
+        {
+            if (obj->m_siblingIndex == GameObject::NoSiblingIndex)
+            {
+                continue;
+            }
+
+            auto objHolder = DetachObject(obj);
+            if (keepObjects)
+            {
+                RetireObject(obj);
+                m_destroyedObjects.push_back(std::move(objHolder));
+            }
+        }
+        m_destroyQueue.clear();
+    }
+
+    void Scene::RetireObject(GameObject* obj)
+    {
+        // Out of the systems and dead, so nothing submits or resolves it
+        // before it is released
+        obj->m_isAlive = false;
+        for (auto& component : obj->m_components)
+        {
+            RemoveFromSystem(component.get());
+        }
+        for (auto& child : obj->m_children)
+        {
+            RetireObject(child.get());
+        }
     }
 
-    std::vector<LightData> Scene::CollectLights()
+    void Scene::ReleaseDestroyedObjects()
     {
-        std::vector<LightData> lights;
+        m_destroyedObjects.clear();
+    }
+
+    void Scene::RegisterName(GameObject* obj)
+    {
+        std::unique_lock<std::mutex> lock(m_structureMutex, std::defer_lock);
+        if (m_isUpdating)
+        {
+            lock.lock();
+        }
+        m_nameIndex[obj->GetName()].push_back(obj);
+    }
+
+    void Scene::UnregisterName(GameObject* obj)
+    {
+        std::unique_lock<std::mutex> lock(m_structureMutex, std::defer_lock);
+        if (m_isUpdating)
+        {
+            lock.lock();
+        }
+        auto it = m_nameIndex.find(obj->GetName());
+        if (it == m_nameIndex.end())
+        {
+            return;
+        }
+
+        auto& objects = it->second;
+        auto objIt = std::find(objects.begin(), objects.end(), obj);
+        if (objIt != objects.end())
+        {
+            objects.erase(objIt);
+        }
+
+        if (objects.empty())
+        {
+            m_nameIndex.erase(it);
+        }
+    }
+
+    TransformStore& Scene::GetTransformStore()
+    {
+        return m_transforms;
+    }
+
+    void Scene::SetParallelUpdate(bool parallel)
+    {
+        m_parallelUpdate = parallel;
+    }
+
+    bool Scene::IsParallelUpdate() const
+    {
+        return m_parallelUpdate;
+    }
+
+    FrameVector<LightData> Scene::CollectLights()
+    {
+        FrameVector<LightData> lights;
         for (auto& obj : m_objects)
         {
             CollectLightsRecursive(obj.get(), lights);
@@ -270,6 +738,7 @@ namespace eng
 
     std::shared_ptr<Scene> Scene::Load(const std::string& path)
     {
+        ENG_PROFILE_SCOPE("Scene::Load");
         const std::string contents = Engine::GetInstance().GetFileSystem().LoadAssetFileText(path);
         if (contents.empty())
         {
@@ -299,34 +768,31 @@ namespace eng
         if (json.contains("camera"))
         {
             std::string cameraObjName = json.value("camera", "");
-            for (const auto& child : result->m_objects)
+            if (auto object = result->FindObjectByName(cameraObjName))
             {
-                if (auto object = child->FindChildByName(cameraObjName))
-                {
-                    result->SetMainCamera(object);
-                    break;
-                }
+                result->SetMainCamera(object);
             }
         }
 
         std::string activeCanvasName = json.value("activeCanvas", "");
-        for (auto& child : result->m_objects)
+        if (auto canvasObject = result->FindObjectByName(activeCanvasName))
         {
-            if (auto canvasObject = child->FindChildByName(activeCanvasName))
+            if (auto component = canvasObject->GetComponent<CanvasComponent>())
             {
-                if (auto component = canvasObject->GetComponent<CanvasComponent>())
-                {
-                    Engine::GetInstance().GetUIInputSystem().SetCanvas(component);
-                    break;
-                }
+                Engine::GetInstance().GetUIInputSystem().SetCanvas(component);
             }
         }
 
         return result;
     }
 
-    void Scene::CollectLightsRecursive(GameObject* obj, std::vector<LightData>& out)
+    void Scene::CollectLightsRecursive(GameObject* obj, FrameVector<LightData>& out)
     {
+        if (!obj->IsActive())
+        {
+            return;
+        }
+
         if (auto light = obj->GetComponent<LightComponent>())
         {
             LightData data;
@@ -1,10 +1,15 @@
 #pragma once
 #include "scene/GameObject.h"
+#include "scene/EntityHandle.h"
+#include "scene/TransformStore.h"
+#include "memory/FrameAllocator.h"
 #include "Common.h"
 
 #include <vector>
 #include <string>
 #include <memory>
+#include <unordered_map>
+#include <mutex>
 
 namespace eng
 {
@@ -12,7 +17,12 @@ namespace eng
     {
     public:
         static void RegisterTypes();
+        // One simulation step. With a fixed timestep the engine may run it
+        // several times per frame, or not at all.
         void Update(float deltaTime);
+        // Runs the Late systems, which submit the render commands. Called by
+        // the engine for the current scene once per frame.
+        void LateUpdate(float deltaTime);
         void Clear();
 
         GameObject* CreateObject(const std::string& name, GameObject* parent = nullptr);
@@ -22,37 +32,113 @@ namespace eng
         T* CreateObject(const std::string& name, GameObject* parent = nullptr)
         {
             auto obj = new T();
-            obj->SetName(name);
             obj->m_scene = this;
-            if (m_isUpdating)
-            {
-                m_objectsToAdd.push_back({ obj, parent });
-            }
-            else
-            {
-                SetParent(obj, parent);
-            }
+            InitEntity(obj);
+            InitTransform(obj);
+            obj->SetName(name);
+            SetParent(obj, parent);
             return obj;
         }
 
+        // False for a cycle or the current parent. During Update the change
+        // is checked right away but only applied once the update is over.
         bool SetParent(GameObject* obj, GameObject* parent);
+        // First live object with the given name in depth first order
         GameObject* FindObjectByName(const std::string& name);
+        // Same, in the subtree of root, root included
+        GameObject* FindObjectByName(const std::string& name, GameObject* root);
+
+        // Null if the handle is stale or the object is marked for destroy.
+        // Objects created during an update resolve once the update is over.
+        GameObject* Resolve(EntityHandle handle);
 
         void SetMainCamera(GameObject* camera);
         GameObject* GetMainCamera();
 
-        std::vector<LightData> CollectLights();
+        // Allocated from the frame allocator of the engine
+        FrameVector<LightData> CollectLights();
+
+        TransformStore& GetTransformStore();
+
+        // Updates the root objects on all threads of the job system. Only
+        // safe when the update of every root subtree touches nothing
+        // outside of it.
+        void SetParallelUpdate(bool parallel);
+        bool IsParallelUpdate() const;
+
+        // With a pipelined engine the previous frame may still be drawn
+        // from the components of destroyed objects, so they are only
+        // deleted here, on the main thread once the draw is done
+        void ReleaseDestroyedObjects();
 
         static std::shared_ptr<Scene> Load(const std::string& path);
 
     private:
-        void CollectLightsRecursive(GameObject* obj, std::vector<LightData>& out);
+        void CollectLightsRecursive(GameObject* obj, FrameVector<LightData>& out);
         void LoadObject(const nlohmann::json& jsonObject, GameObject* parent);
+        bool CanSetParent(GameObject* obj, GameObject* parent) const;
+        // Parent the object will have once the queued changes are applied,
+        // queued is set if there are any for it
+        GameObject* GetPendingParent(GameObject* obj, bool& queued) const;
+        std::unique_ptr<GameObject> DetachObject(GameObject* obj);
+        void AddToSystem(Component* component);
+        void InsertIntoSystem(Component* component);
+        void RemoveFromSystem(Component* component);
+        void CompactSystems();
+        void SortSystems();
+        // Renumbers the objects in depth first order if the tree changed
+        void UpdateHierarchyOrder();
+        void AssignHierarchyOrder(GameObject* obj, uint32_t& order);
+        void RunSystems(UpdatePhase phase, float deltaTime);
+        void InitEntity(GameObject* obj);
+        void CommitEntity(GameObject* obj);
+        void ReleaseEntity(GameObject* obj);
+        void InitTransform(GameObject* obj);
+        void CommitTransform(GameObject* obj);
+        void QueueDestroy(GameObject* obj);
+        void DestroyQueuedObjects();
+        void RetireObject(GameObject* obj);
+        void RegisterName(GameObject* obj);
+        void UnregisterName(GameObject* obj);
 
     private:
+        struct EntitySlot
+        {
+            GameObject* object = nullptr;
+            uint32_t generation = 0;
+        };
+
+    private:
+        // Declared before the objects so they outlive them on destruction
+        TransformStore m_transforms;
+        // Guards the queues, the name index and the entity table during
+        // parallel updates
+        std::mutex m_structureMutex;
+        std::vector<EntitySlot> m_entities;
+        std::vector<uint32_t> m_freeEntities;
+        // Indices handed out so far, can run ahead of m_entities during an
+        // update, the table only grows at the sync point
+        uint32_t m_entityCount = 0;
+        std::unordered_map<std::string, std::vector<GameObject*>> m_nameIndex;
+        // Components of the Early and Late phases, one array per type id.
+        // Removed entries stay null until the next compaction.
+        std::vector<std::vector<Component*>> m_systems;
+        std::vector<Component*> m_systemsToAdd;
+        bool m_systemsNeedCompaction = false;
+        // Set by reparents and by adds to systems with SystemOrder::Hierarchy,
+        // only those systems are kept in hierarchy order
+        bool m_systemsNeedSort = false;
+        bool m_hierarchyOrderDirty = false;
         std::vector<std::unique_ptr<GameObject>> m_objects;
         std::vector<std::pair<GameObject*, GameObject*>> m_objectsToAdd;
-        GameObject* m_mainCamera = nullptr;
+        // Last queued parent of every object in m_objectsToAdd
+        std::unordered_map<GameObject*, GameObject*> m_pendingParents;
+        std::vector<GameObject*> m_destroyQueue;
+        std::vector<std::unique_ptr<GameObject>> m_destroyedObjects;
+        EntityHandle m_mainCamera;
         bool m_isUpdating = false;
+        bool m_parallelUpdate = false;
+
+        friend class GameObject;
     };
 }
\ No newline at end of file
@@ -0,0 +1,461 @@
+#include "scene/TransformStore.h"
+#include "profiling/Profiler.h"
+
+#include <glm/geometric.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace eng
+{
+    uint32_t TransformStore::Create()
+    {
+        uint32_t id = 0;
+        if (!m_freeIds.empty())
+        {
+            id = m_freeIds.back();
+            m_freeIds.pop_back();
+        }
+        else
+        {
+            id = static_cast<uint32_t>(m_idToSlot.size());
+            m_idToSlot.push_back(InvalidIndex);
+        }
+
+        // New transforms have no parent yet, so appending keeps the order valid
+        const uint32_t slot = static_cast<uint32_t>(m_parents.size());
+        m_positions.push_back(glm::vec3(0.0f));
+        m_rotations.push_back(glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
+        m_scales.push_back(glm::vec3(1.0f));
+        m_parents.push_back(InvalidIndex);
+        m_world.push_back(glm::mat4(1.0f));
+        m_world2D.push_back(glm::mat4(1.0f));
+        m_previousWorld.push_back(glm::mat4(1.0f));
+        m_flags.push_back(Alive | WorldDirty | World2DDirty);
+        m_slotToId.push_back(id);
+
+        m_idToSlot[id] = slot;
+        return id;
+    }
+
+    void TransformStore::Destroy(uint32_t id)
+    {
+        if (id >= m_idToSlot.size() || m_idToSlot[id] == InvalidIndex)
+        {
+            return;
+        }
+
+        // The slot is only released on the next sort, so the order of the
+        // remaining slots stays intact until then
+        const uint32_t slot = m_idToSlot[id];
+        m_flags[slot] = 0;
+        m_parents[slot] = InvalidIndex;
+        m_slotToId[slot] = InvalidIndex;
+        m_idToSlot[id] = InvalidIndex;
+        m_freeIds.push_back(id);
+        m_needsSort = true;
+    }
+
+    void TransformStore::Clear()
+    {
+        m_positions.clear();
+        m_rotations.clear();
+        m_scales.clear();
+        m_parents.clear();
+        m_world.clear();
+        m_world2D.clear();
+        m_previousWorld.clear();
+        m_flags.clear();
+        m_slotToId.clear();
+        m_idToSlot.clear();
+        m_freeIds.clear();
+        m_needsSort = false;
+    }
+
+    size_t TransformStore::GetSize() const
+    {
+        return m_idToSlot.size() - m_freeIds.size();
+    }
+
+    void TransformStore::SetParent(uint32_t id, uint32_t parentId)
+    {
+        const uint32_t slot = m_idToSlot[id];
+        const uint32_t parentSlot = parentId != InvalidIndex ? m_idToSlot[parentId] : InvalidIndex;
+        m_parents[slot] = parentSlot;
+
+        if (parentSlot != InvalidIndex && parentSlot > slot)
+        {
+            m_needsSort = true;
+        }
+    }
+
+    const glm::vec3& TransformStore::GetPosition(uint32_t id) const
+    {
+        return m_positions[m_idToSlot[id]];
+    }
+
+    void TransformStore::SetPosition(uint32_t id, const glm::vec3& pos)
+    {
+        m_positions[m_idToSlot[id]] = pos;
+    }
+
+    const glm::quat& TransformStore::GetRotation(uint32_t id) const
+    {
+        return m_rotations[m_idToSlot[id]];
+    }
+
+    void TransformStore::SetRotation(uint32_t id, const glm::quat& rot)
+    {
+        m_rotations[m_idToSlot[id]] = rot;
+    }
+
+    const glm::vec3& TransformStore::GetScale(uint32_t id) const
+    {
+        return m_scales[m_idToSlot[id]];
+    }
+
+    void TransformStore::SetScale(uint32_t id, const glm::vec3& scale)
+    {
+        m_scales[m_idToSlot[id]] = scale;
+    }
+
+    glm::mat4 TransformStore::GetLocalTransform(uint32_t id) const
+    {
+        return ComposeLocal(m_idToSlot[id]);
+    }
+
+    glm::mat4 TransformStore::GetLocalTransform2D(uint32_t id) const
+    {
+        return ComposeLocal2D(m_idToSlot[id]);
+    }
+
+    glm::mat4 TransformStore::GetWorldTransform(uint32_t id)
+    {
+        const uint32_t slot = m_idToSlot[id];
+        if (m_concurrentReads && (m_flags[slot] & WorldDirty))
+        {
+            return ComputeWorldTransform(slot);
+        }
+        return GetWorldTransformBySlot(slot);
+    }
+
+    glm::mat4 TransformStore::GetWorldTransform2D(uint32_t id)
+    {
+        const uint32_t slot = m_idToSlot[id];
+        if (m_concurrentReads && (m_flags[slot] & World2DDirty))
+        {
+            return ComputeWorldTransform2D(slot);
+        }
+        return GetWorldTransform2DBySlot(slot);
+    }
+
+    void TransformStore::SetConcurrentReads(bool concurrent)
+    {
+        m_concurrentReads = concurrent;
+    }
+
+    bool TransformStore::MarkDirty(uint32_t id)
+    {
+        auto& flags = m_flags[m_idToSlot[id]];
+        if ((flags & WorldDirty) && (flags & World2DDirty))
+        {
+            return false;
+        }
+
+        flags |= WorldDirty | World2DDirty;
+        return true;
+    }
+
+    void TransformStore::UpdateWorldTransforms()
+    {
+        ENG_PROFILE_SCOPE("TransformStore::UpdateWorldTransforms");
+        if (m_needsSort)
+        {
+            Sort();
+        }
+
+        // Parents precede children, and a dirty parent always has dirty
+        // children, so every parent matrix is final by the time it is read.
+        // Roots multiply by the identity to keep the loop free of branches
+        // past the dirty check.
+        const glm::mat4 identity(1.0f);
+        const size_t count = m_parents.size();
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (!(m_flags[i] & (WorldDirty | World2DDirty)))
+            {
+                continue;
+            }
+
+            const uint32_t parent = m_parents[i];
+            const glm::mat4& parentWorld = parent != InvalidIndex ? m_world[parent] : identity;
+            const glm::mat4& parentWorld2D = parent != InvalidIndex ? m_world2D[parent] : identity;
+            m_world[i] = parentWorld * ComposeLocal(static_cast<uint32_t>(i));
+            m_world2D[i] = parentWorld2D * ComposeLocal2D(static_cast<uint32_t>(i));
+            m_flags[i] &= ~(WorldDirty | World2DDirty);
+        }
+    }
+
+    void TransformStore::StorePreviousWorldTransforms()
+    {
+        UpdateWorldTransforms();
+
+        m_previousWorld = m_world;
+        for (auto& flags : m_flags)
+        {
+            if (flags & Alive)
+            {
+                flags |= HasPrevious;
+            }
+        }
+    }
+
+    glm::mat4 TransformStore::GetInterpolatedWorldTransform(uint32_t id, float alpha)
+    {
+        const uint32_t slot = m_idToSlot[id];
+        const glm::mat4 world = GetWorldTransform(id);
+        if (alpha >= 1.0f || !(m_flags[slot] & HasPrevious))
+        {
+            return world;
+        }
+
+        return Interpolate(m_previousWorld[slot], world, alpha);
+    }
+
+    glm::mat4 TransformStore::Interpolate(const glm::mat4& from, const glm::mat4& to, float alpha)
+    {
+        // Most objects did not move during the step
+        if (from == to)
+        {
+            return to;
+        }
+
+        const glm::vec3 fromScale(glm::length(glm::vec3(from[0])), glm::length(glm::vec3(from[1])), glm::length(glm::vec3(from[2])));
+        const glm::vec3 toScale(glm::length(glm::vec3(to[0])), glm::length(glm::vec3(to[1])), glm::length(glm::vec3(to[2])));
+        if (fromScale.x == 0.0f || fromScale.y == 0.0f || fromScale.z == 0.0f ||
+            toScale.x == 0.0f || toScale.y == 0.0f || toScale.z == 0.0f)
+        {
+            return to;
+        }
+
+        const glm::quat fromRotation = glm::quat_cast(glm::mat3(
+            glm::vec3(from[0]) / fromScale.x, glm::vec3(from[1]) / fromScale.y, glm::vec3(from[2]) / fromScale.z));
+        const glm::quat toRotation = glm::quat_cast(glm::mat3(
+            glm::vec3(to[0]) / toScale.x, glm::vec3(to[1]) / toScale.y, glm::vec3(to[2]) / toScale.z));
+
+        return Compose(
+            glm::mix(glm::vec3(from[3]), glm::vec3(to[3]), alpha),
+            glm::slerp(fromRotation, toRotation, alpha),
+            glm::mix(fromScale, toScale, alpha));
+    }
+
+    const glm::mat4& TransformStore::GetWorldTransformBySlot(uint32_t slot)
+    {
+        if (m_flags[slot] & WorldDirty)
+        {
+            const uint32_t parent = m_parents[slot];
+            if (parent != InvalidIndex)
+            {
+                m_world[slot] = GetWorldTransformBySlot(parent) * ComposeLocal(slot);
+            }
+            else
+            {
+                m_world[slot] = ComposeLocal(slot);
+            }
+            m_flags[slot] &= ~WorldDirty;
+        }
+
+        return m_world[slot];
+    }
+
+    const glm::mat4& TransformStore::GetWorldTransform2DBySlot(uint32_t slot)
+    {
+        if (m_flags[slot] & World2DDirty)
+        {
+            const uint32_t parent = m_parents[slot];
+            if (parent != InvalidIndex)
+            {
+                m_world2D[slot] = GetWorldTransform2DBySlot(parent) * ComposeLocal2D(slot);
+            }
+            else
+            {
+                m_world2D[slot] = ComposeLocal2D(slot);
+            }
+            m_flags[slot] &= ~World2DDirty;
+        }
+
+        return m_world2D[slot];
+    }
+
+    glm::mat4 TransformStore::ComputeWorldTransform(uint32_t slot) const
+    {
+        // Clean slots never have a dirty ancestor, so the walk stops at the
+        // first clean one
+        glm::mat4 world = ComposeLocal(slot);
+        uint32_t parent = m_parents[slot];
+        while (parent != InvalidIndex && (m_flags[parent] & WorldDirty))
+        {
+            world = ComposeLocal(parent) * world;
+            parent = m_parents[parent];
+        }
+
+        return parent != InvalidIndex ? m_world[parent] * world : world;
+    }
+
+    glm::mat4 TransformStore::ComputeWorldTransform2D(uint32_t slot) const
+    {
+        glm::mat4 world = ComposeLocal2D(slot);
+        uint32_t parent = m_parents[slot];
+        while (parent != InvalidIndex && (m_flags[parent] & World2DDirty))
+        {
+            world = ComposeLocal2D(parent) * world;
+            parent = m_parents[parent];
+        }
+
+        return parent != InvalidIndex ? m_world2D[parent] * world : world;
+    }
+
+    glm::mat4 TransformStore::ComposeLocal(uint32_t slot) const
+    {
+        return Compose(m_positions[slot], m_rotations[slot], m_scales[slot]);
+    }
+
+    glm::mat4 TransformStore::ComposeLocal2D(uint32_t slot) const
+    {
+        return Compose2D(m_positions[slot], m_rotations[slot], m_scales[slot]);
+    }
+
+    glm::mat4 TransformStore::Compose(const glm::vec3& pos, const glm::quat& rot, const glm::vec3& scale)
+    {
+        // Same as translate * rotate * scale without the full matrix products
+        const glm::mat3 rotation = glm::mat3_cast(rot);
+
+        glm::mat4 mat;
+        mat[0] = glm::vec4(rotation[0] * scale.x, 0.0f);
+        mat[1] = glm::vec4(rotation[1] * scale.y, 0.0f);
+        mat[2] = glm::vec4(rotation[2] * scale.z, 0.0f);
+        mat[3] = glm::vec4(pos, 1.0f);
+
+        return mat;
+    }
+
+    glm::mat4 TransformStore::Compose2D(const glm::vec3& pos, const glm::quat& rot, const glm::vec3& scale)
+    {
+        glm::mat4 mat = glm::mat4(1.0f);
+
+        // cos and sin of glm::angle(rot), which is 2 * acos(w), without the
+        // trigonometric calls
+        const float w = rot.w;
+        const float c = 2.0f * w * w - 1.0f;
+        const float s = 2.0f * w * std::sqrt(std::max(0.0f, 1.0f - w * w));
+
+        mat[0][0] = scale.x * c;
+        mat[0][1] = scale.x * s;
+        mat[1][0] = -scale.y * s;
+        mat[1][1] = scale.y * c;
+        mat[3][0] = pos.x;
+        mat[3][1] = pos.y;
+
+        return mat;
+    }
+
+    void TransformStore::Sort()
+    {
+        const uint32_t count = static_cast<uint32_t>(m_parents.size());
+
+        // Depth of every live slot. The walk stops at the first ancestor
+        // whose depth is already known, so each slot is visited once.
+        std::vector<uint32_t> depth(count, InvalidIndex);
+        std::vector<uint32_t> chain;
+        uint32_t maxDepth = 0;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (!(m_flags[i] & Alive) || depth[i] != InvalidIndex)
+            {
+                continue;
+            }
+
+            chain.clear();
+            uint32_t current = i;
+            while (current != InvalidIndex && depth[current] == InvalidIndex)
+            {
+                chain.push_back(current);
+                current = m_parents[current];
+            }
+
+            uint32_t d = current != InvalidIndex ? depth[current] + 1 : 0;
+            for (auto it = chain.rbegin(); it != chain.rend(); ++it)
+            {
+                depth[*it] = d++;
+            }
+            maxDepth = std::max(maxDepth, d);
+        }
+
+        // Stable counting sort by depth drops dead slots and puts every
+        // parent in front of its children
+        std::vector<uint32_t> offsets(maxDepth + 1, 0);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (depth[i] != InvalidIndex)
+            {
+                ++offsets[depth[i] + 1];
+            }
+        }
+        for (size_t d = 1; d < offsets.size(); ++d)
+        {
+            offsets[d] += offsets[d - 1];
+        }
+
+        const uint32_t liveCount = offsets.back();
+        std::vector<uint32_t> newSlot(count, InvalidIndex);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (depth[i] != InvalidIndex)
+            {
+                newSlot[i] = offsets[depth[i]]++;
+            }
+        }
+
+        std::vector<glm::vec3> positions(liveCount);
+        std::vector<glm::quat> rotations(liveCount);
+        std::vector<glm::vec3> scales(liveCount);
+        std::vector<uint32_t> parents(liveCount);
+        std::vector<glm::mat4> world(liveCount);
+        std::vector<glm::mat4> world2D(liveCount);
+        std::vector<glm::mat4> previousWorld(liveCount);
+        std::vector<uint8_t> flags(liveCount);
+        std::vector<uint32_t> slotToId(liveCount);
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const uint32_t slot = newSlot[i];
+            if (slot == InvalidIndex)
+            {
+                continue;
+            }
+
+            positions[slot] = m_positions[i];
+            rotations[slot] = m_rotations[i];
+            scales[slot] = m_scales[i];
+            parents[slot] = m_parents[i] != InvalidIndex ? newSlot[m_parents[i]] : InvalidIndex;
+            world[slot] = m_world[i];
+            world2D[slot] = m_world2D[i];
+            previousWorld[slot] = m_previousWorld[i];
+            flags[slot] = m_flags[i];
+            slotToId[slot] = m_slotToId[i];
+            m_idToSlot[m_slotToId[i]] = slot;
+        }
+
+        m_positions.swap(positions);
+        m_rotations.swap(rotations);
+        m_scales.swap(scales);
+        m_parents.swap(parents);
+        m_world.swap(world);
+        m_world2D.swap(world2D);
+        m_previousWorld.swap(previousWorld);
+        m_flags.swap(flags);
+        m_slotToId.swap(slotToId);
+
+        m_needsSort = false;
+    }
+}
\ No newline at end of file
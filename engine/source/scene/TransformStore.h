@@ -0,0 +1,101 @@
+#pragma once
+
+#include <glm/vec3.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/mat4x4.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace eng
+{
+    // Local and world transforms of all objects of a scene, kept in
+    // structure-of-arrays buffers. Slots are ordered so that a parent always
+    // comes before its children, which lets the world matrices be rebuilt
+    // in a single linear sweep. Objects refer to their transform through a
+    // stable id that survives reordering of the slots.
+    class TransformStore
+    {
+    public:
+        static constexpr uint32_t InvalidIndex = 0xFFFFFFFF;
+
+        uint32_t Create();
+        void Destroy(uint32_t id);
+        void Clear();
+        size_t GetSize() const;
+
+        void SetParent(uint32_t id, uint32_t parentId);
+
+        const glm::vec3& GetPosition(uint32_t id) const;
+        void SetPosition(uint32_t id, const glm::vec3& pos);
+        const glm::quat& GetRotation(uint32_t id) const;
+        void SetRotation(uint32_t id, const glm::quat& rot);
+        const glm::vec3& GetScale(uint32_t id) const;
+        void SetScale(uint32_t id, const glm::vec3& scale);
+
+        glm::mat4 GetLocalTransform(uint32_t id) const;
+        glm::mat4 GetLocalTransform2D(uint32_t id) const;
+        glm::mat4 GetWorldTransform(uint32_t id);
+        glm::mat4 GetWorldTransform2D(uint32_t id);
+
+        static glm::mat4 Compose(const glm::vec3& pos, const glm::quat& rot, const glm::vec3& scale);
+        static glm::mat4 Compose2D(const glm::vec3& pos, const glm::quat& rot, const glm::vec3& scale);
+
+        // Returns false if the transform was already dirty
+        bool MarkDirty(uint32_t id);
+
+        // While set, the world matrix of a dirty transform is computed on
+        // every read and not stored, so several threads can read at once.
+        // Used during a parallel scene update.
+        void SetConcurrentReads(bool concurrent);
+
+        // Rebuilds every dirty world matrix, 3D and 2D, in one pass over the
+        // buffers
+        void UpdateWorldTransforms();
+
+        // Remembers the current world matrices as the previous ones, called
+        // at the start of every fixed simulation step
+        void StorePreviousWorldTransforms();
+        // Blend from the previous to the current world matrix, alpha 1 is
+        // the current one. Transforms created since the last store are not
+        // blended.
+        glm::mat4 GetInterpolatedWorldTransform(uint32_t id, float alpha);
+        static glm::mat4 Interpolate(const glm::mat4& from, const glm::mat4& to, float alpha);
+
+    private:
+        enum Flags : uint8_t
+        {
+            Alive = 1 << 0,
+            WorldDirty = 1 << 1,
+            World2DDirty = 1 << 2,
+            HasPrevious = 1 << 3
+        };
+
+        const glm::mat4& GetWorldTransformBySlot(uint32_t slot);
+        const glm::mat4& GetWorldTransform2DBySlot(uint32_t slot);
+        // World matrix of a dirty slot without writing to the store
+        glm::mat4 ComputeWorldTransform(uint32_t slot) const;
+        glm::mat4 ComputeWorldTransform2D(uint32_t slot) const;
+        glm::mat4 ComposeLocal(uint32_t slot) const;
+        glm::mat4 ComposeLocal2D(uint32_t slot) const;
+        void Sort();
+
+    private:
+        std::vector<glm::vec3> m_positions;
+        std::vector<glm::quat> m_rotations;
+        std::vector<glm::vec3> m_scales;
+        std::vector<uint32_t> m_parents;
+        std::vector<glm::mat4> m_world;
+        std::vector<glm::mat4> m_world2D;
+        std::vector<glm::mat4> m_previousWorld;
+        std::vector<uint8_t> m_flags;
+        std::vector<uint32_t> m_slotToId;
+
+        std::vector<uint32_t> m_idToSlot;
+        std::vector<uint32_t> m_freeIds;
+
+        // Set when a slot was destroyed or a child ended up before its parent
+        bool m_needsSort = false;
+        bool m_concurrentReads = false;
+    };
+}
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "scene/components/AnimationComponent.h"
 #include "scene/GameObject.h"
+#include "scene/Scene.h"
 
 namespace eng
 {
@@ -31,11 +32,17 @@ namespace eng
             }
         }
 
+        auto scene = m_owner->GetScene();
         for (auto& binding : m_bindings)
         {
-            auto& obj = binding.first;
-            auto& trackIndices = binding.second->trackIndices;
-            for (auto i : trackIndices)
+            // Targets destroyed since the bindings were built are skipped
+            auto obj = scene->Resolve(binding.object);
+            if (!obj)
+            {
+                continue;
+            }
+
+            for (auto i : binding.trackIndices)
             {
                 auto& track = m_clip->tracks[i];
                 if (!track.positions.empty())
@@ -102,23 +109,27 @@ namespace eng
             return;
         }
 
+        // Index of the binding of every target, bindings themselves are
+        // kept in a flat array for the update
+        std::unordered_map<EntityHandle, size_t> bindingIndices;
         for (size_t i = 0; i < m_clip->tracks.size(); ++i)
         {
             auto& track = m_clip->tracks[i];
             auto targetObject = m_owner->FindChildByName(track.targetName);
             if (targetObject)
             {
-                auto it = m_bindings.find(targetObject);
-                if (it != m_bindings.end())
+                auto handle = targetObject->GetHandle();
+                auto it = bindingIndices.find(handle);
+                if (it != bindingIndices.end())
                 {
-                    it->second->trackIndices.push_back(i);
+                    m_bindings[it->second].trackIndices.push_back(i);
                 }
                 else
                 {
-                    auto binding = std::make_unique<ObjectBinding>();
-                    binding->object = targetObject;
-                    binding->trackIndices.push_back(i);
-                    m_bindings.emplace(targetObject, std::move(binding));
+                    bindingIndices.emplace(handle, m_bindings.size());
+                    auto& binding = m_bindings.emplace_back();
+                    binding.object = handle;
+                    binding.trackIndices.push_back(i);
                 }
             }
         }
@@ -1,5 +1,6 @@
 #pragma once
 #include "scene/Component.h"
+#include "scene/EntityHandle.h"
 
 #include <glm/vec3.hpp>
 #include <glm/gtc/quaternion.hpp>
@@ -41,13 +42,13 @@ namespace eng
 
     struct ObjectBinding
     {
-        GameObject* object = nullptr;
+        EntityHandle object;
         std::vector<size_t> trackIndices;
     };
 
-    class AnimationComponent : public Component
+    class AnimationComponent final : public Component
     {
-        COMPONENT(AnimationComponent)
+        COMPONENT_SYSTEM(AnimationComponent, eng::UpdatePhase::Early)
     public:
         void Update(float deltaTime) override;
         void SetClip(AnimationClip* clip);
@@ -68,6 +69,6 @@ namespace eng
         bool m_isPlaying = false;
 
         std::unordered_map<std::string, std::shared_ptr<AnimationClip>> m_clips;
-        std::unordered_map<GameObject*, std::unique_ptr<ObjectBinding>> m_bindings;
+        std::vector<ObjectBinding> m_bindings;
     };
 }
\ No newline at end of file
@@ -4,9 +4,9 @@
 
 namespace eng
 {
-    class AudioComponent : public Component
+    class AudioComponent final : public Component
     {
-        COMPONENT(AudioComponent)
+        COMPONENT_SYSTEM(AudioComponent, eng::UpdatePhase::Late)
     public:
         void LoadProperties(const nlohmann::json& json) override;
         void Update(float deltaTime) override;
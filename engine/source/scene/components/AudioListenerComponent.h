@@ -3,9 +3,9 @@
 
 namespace eng
 {
-    class AudioListenerComponent : public Component
+    class AudioListenerComponent final : public Component
     {
-        COMPONENT(AudioListenerComponent)
+        COMPONENT_SYSTEM(AudioListenerComponent, eng::UpdatePhase::Late)
     public:
         void Update(float deltaTime) override;
     };
@@ -23,6 +23,22 @@ namespace eng
         return glm::inverse(mat);
     }
 
+    glm::mat4 CameraComponent::GetViewMatrix(float alpha) const
+    {
+        if (alpha >= 1.0f)
+        {
+            return GetViewMatrix();
+        }
+
+        // Scale of the camera object is not part of the view
+        glm::mat4 mat = m_owner->GetInterpolatedWorldTransform(alpha);
+        mat[0] = glm::vec4(glm::normalize(glm::vec3(mat[0])), 0.0f);
+        mat[1] = glm::vec4(glm::normalize(glm::vec3(mat[1])), 0.0f);
+        mat[2] = glm::vec4(glm::normalize(glm::vec3(mat[2])), 0.0f);
+
+        return glm::inverse(mat);
+    }
+
     glm::mat4 CameraComponent::GetProjectionMatrix(float aspect) const
     {
         return glm::perspective(glm::radians(m_fov), aspect, m_nearPlane, m_farPlane);
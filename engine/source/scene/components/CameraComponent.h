@@ -5,13 +5,15 @@
 
 namespace eng
 {
-    class CameraComponent : public Component
+    class CameraComponent final : public Component
     {
-        COMPONENT(CameraComponent)
+        COMPONENT_SYSTEM(CameraComponent, eng::UpdatePhase::Never)
     public:
         void Update(float deltaTime) override;
 
         glm::mat4 GetViewMatrix() const;
+        // View between the last two fixed simulation steps
+        glm::mat4 GetViewMatrix(float alpha) const;
         glm::mat4 GetProjectionMatrix(float aspect) const;
 
     private:
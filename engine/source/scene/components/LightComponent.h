@@ -6,9 +6,9 @@
 
 namespace eng
 {
-    class LightComponent : public Component
+    class LightComponent final : public Component
     {
-        COMPONENT(LightComponent)
+        COMPONENT_SYSTEM(LightComponent, eng::UpdatePhase::Never)
     public:
         void LoadProperties(const nlohmann::json& json) override;
         void Update(float deltaTime) override;
@@ -107,7 +107,7 @@ namespace eng
         RenderCommand command;
         command.material = m_material.get();
         command.mesh = m_mesh.get();
-        command.modelMatrix = GetOwner()->GetWorldTransform();
+        command.modelMatrix = GetOwner()->GetInterpolatedWorldTransform(Engine::GetInstance().GetInterpolationAlpha());
 
         auto& renderQueue = Engine::GetInstance().GetRenderQueue();
         renderQueue.Submit(command);
@@ -8,9 +8,9 @@ namespace eng
     class Material;
     class Mesh;
 
-    class MeshComponent : public Component
+    class MeshComponent final : public Component
     {
-        COMPONENT(MeshComponent)
+        COMPONENT_SYSTEM(MeshComponent, eng::UpdatePhase::Late)
     public:
         MeshComponent() = default;
         MeshComponent(const std::shared_ptr<Material>& material, const std::shared_ptr<Mesh>& mesh);
@@ -4,9 +4,9 @@
 
 namespace eng
 {
-    class PhysicsComponent : public Component
+    class PhysicsComponent final : public Component
     {
-        COMPONENT(PhysicsComponent)
+        COMPONENT_SYSTEM(PhysicsComponent, eng::UpdatePhase::Early)
     public:
         PhysicsComponent() = default;
         PhysicsComponent(const std::shared_ptr<RigidBody>& body);
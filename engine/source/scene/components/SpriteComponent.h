@@ -10,9 +10,9 @@ namespace eng
 {
     class Texture;
 
-    class SpriteComponent : public Component
+    class SpriteComponent final : public Component
     {
-        COMPONENT(SpriteComponent)
+        COMPONENT_SYSTEM_ORDERED(SpriteComponent, eng::UpdatePhase::Late, eng::SystemOrder::Hierarchy)
     public:
         void LoadProperties(const nlohmann::json& json) override;
         void Update(float deltaTime) override;
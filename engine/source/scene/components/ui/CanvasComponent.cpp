@@ -5,6 +5,7 @@
 #include "graphics/VertexLayout.h"
 #include "render/Mesh.h"
 #include "Engine.h"
+#include "profiling/Profiler.h"
 
 namespace eng
 {
@@ -34,6 +35,11 @@ namespace eng
         const auto& children = m_owner->GetChildren();
         for (const auto& child : children)
         {
+            if (!child->IsActive())
+            {
+                continue;
+            }
+
             if (auto comp = child->GetComponent<UIElementComponent>())
             {
                 Render(comp);
@@ -83,6 +89,11 @@ namespace eng
         const auto& children = element->GetOwner()->GetChildren();
         for (const auto& child : children)
         {
+            if (!child->IsActive())
+            {
+                continue;
+            }
+
             if (auto comp = child->GetComponent<UIElementComponent>())
             {
                 Render(comp);
@@ -99,27 +110,34 @@ namespace eng
 
     void CanvasComponent::Flush()
     {
-        m_mesh->UpdateDynamic(m_vertices, m_indices);
+        ENG_PROFILE_SCOPE("CanvasComponent::Flush");
         auto& gfx = Engine::GetInstance().GetGraphicsAPI();
         const auto& viewport = gfx.GetViewport();
 
         RenderCommandUI command;
         command.mesh = m_mesh.get();
         command.shaderProgram = gfx.GetDefaultUIShaderProgram().get();
-        command.batches = m_batches;
+        command.batches.assign(m_batches.begin(), m_batches.end());
+        command.vertices.assign(m_vertices.begin(), m_vertices.end());
+        command.indices.assign(m_indices.begin(), m_indices.end());
         command.screenWidth = viewport.width;
         command.screenHeight = viewport.height;
 
-        Engine::GetInstance().GetRenderQueue().Submit(command);
+        Engine::GetInstance().GetRenderQueue().Submit(std::move(command));
     }
 
-    void CanvasComponent::CollectUI(UIElementComponent* element, std::vector<UIElementComponent*>& out)
+    void CanvasComponent::CollectUI(UIElementComponent* element, FrameVector<UIElementComponent*>& out)
     {
         out.push_back(element);
 
         const auto& children = element->GetOwner()->GetChildren();
         for (const auto& child : children)
         {
+            if (!child->IsActive())
+            {
+                continue;
+            }
+
             if (auto component = child->GetComponent<UIElementComponent>())
             {
                 CollectUI(component, out);
@@ -2,6 +2,7 @@
 
 #include "Common.h"
 #include "scene/Component.h"
+#include "memory/FrameAllocator.h"
 
 #include <glm/vec2.hpp>
 #include <glm/vec4.hpp>
@@ -15,9 +16,9 @@ namespace eng
     class Texture;
     class Mesh;
 
-    class CanvasComponent : public Component
+    class CanvasComponent final : public Component
     {
-        COMPONENT(CanvasComponent)
+        COMPONENT_SYSTEM_ORDERED(CanvasComponent, eng::UpdatePhase::Late, eng::SystemOrder::Hierarchy)
     public:
         void LoadProperties(const nlohmann::json& json) override;
         void Update(float deltaTime) override;
@@ -25,7 +26,7 @@ namespace eng
         void Render(UIElementComponent* element);
         void BeginRendering();
         void Flush();
-        void CollectUI(UIElementComponent* element, std::vector<UIElementComponent*>& out);
+        void CollectUI(UIElementComponent* element, FrameVector<UIElementComponent*>& out);
 
         void DrawRect(
             const glm::vec2& lowerLeftPos, const glm::vec2& upperRightPos,
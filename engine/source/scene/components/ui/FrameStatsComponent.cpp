@@ -0,0 +1,116 @@
+#include "scene/components/ui/FrameStatsComponent.h"
+#include "scene/components/ui/CanvasComponent.h"
+#include "scene/components/ui/RectTransformComponent.h"
+#include "scene/GameObject.h"
+#include "scene/Scene.h"
+#include "Engine.h"
+
+#include <iomanip>
+#include <sstream>
+
+namespace eng
+{
+    void FrameStatsComponent::LoadProperties(const nlohmann::json& json)
+    {
+        TextComponent::LoadProperties(json);
+        SetRefreshInterval(json.value("refresh", 0.5f));
+    }
+
+    void FrameStatsComponent::Update(float deltaTime)
+    {
+        m_timeToRefresh -= deltaTime;
+        if (m_timeToRefresh > 0.0f)
+        {
+            return;
+        }
+
+        m_timeToRefresh = m_refreshInterval;
+        Refresh();
+    }
+
+    float FrameStatsComponent::GetRefreshInterval() const
+    {
+        return m_refreshInterval;
+    }
+
+    void FrameStatsComponent::SetRefreshInterval(float seconds)
+    {
+        m_refreshInterval = seconds;
+    }
+
+    GameObject* FrameStatsComponent::CreateOverlay(Scene* scene, const std::string& fontPath, int fontSize)
+    {
+        auto canvasObject = scene->CreateObject("FrameStatsOverlay");
+        canvasObject->AddComponent(new RectTransformComponent());
+        canvasObject->AddComponent(new CanvasComponent());
+
+        auto textObject = scene->CreateObject("FrameStats", canvasObject);
+        textObject->SetPosition2D(glm::vec2(10.0f, -10.0f));
+
+        auto rect = new RectTransformComponent();
+        rect->SetAnchor(glm::vec2(0.0f, 1.0f));
+        rect->SetPivot(glm::vec2(0.0f, 1.0f));
+        textObject->AddComponent(rect);
+
+        auto stats = new FrameStatsComponent();
+        stats->SetFont(fontPath, fontSize);
+        textObject->AddComponent(stats);
+
+        return canvasObject;
+    }
+
+    void FrameStatsComponent::Refresh()
+    {
+        const auto& frameStats = Engine::GetInstance().GetFrameStats();
+
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(2);
+
+        const auto frame = frameStats.GetStageStats(FrameStage::Frame);
+        out << "frame " << frame.avgMs << " ms"
+            << "  p50 " << frame.p50Ms
+            << "  p95 " << frame.p95Ms
+            << "  p99 " << frame.p99Ms
+            << "  max " << frame.maxMs << "\n";
+
+        // Frames that missed 60 and 30 fps, the histogram edges at 16.7 and
+        // 33.3 ms
+        const auto& histogram = frameStats.GetHistogram();
+        const auto& edges = frameStats.GetHistogramEdges();
+        size_t over60 = 0;
+        size_t over30 = 0;
+        for (size_t i = 0; i < histogram.size(); ++i)
+        {
+            if (i > 0 && edges[i - 1] >= 16.7)
+            {
+                over60 += histogram[i];
+            }
+            if (i > 0 && edges[i - 1] >= 33.3)
+            {
+                over30 += histogram[i];
+            }
+        }
+        out << "over 16.7 ms " << over60
+            << "  over 33.3 ms " << over30
+            << "  hitches " << frameStats.GetHitchCount() << "\n";
+
+        // Objects and components created in the last frame, and the ones
+        // the pools could not serve without the heap
+        const auto& frameAllocations = frameStats.GetFrameAllocations();
+        const auto& totalAllocations = frameStats.GetTotalAllocations();
+        out << "allocs " << frameAllocations.allocations
+            << "  frees " << frameAllocations.deallocations
+            << "  heap " << frameAllocations.heapAllocations
+            << "  total heap " << totalAllocations.heapAllocations << "\n";
+
+        for (size_t i = 1; i < FrameStats::StageCount; ++i)
+        {
+            const auto stage = static_cast<FrameStage>(i);
+            const auto stats = frameStats.GetStageStats(stage);
+            out << FrameStats::GetStageName(stage) << " " << stats.avgMs
+                << "  p99 " << stats.p99Ms << "\n";
+        }
+
+        SetText(out.str());
+    }
+}
\ No newline at end of file
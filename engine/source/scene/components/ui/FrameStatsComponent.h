@@ -0,0 +1,33 @@
+#pragma once
+
+#include "scene/components/ui/TextComponent.h"
+
+namespace eng
+{
+    class GameObject;
+    class Scene;
+
+    // Text that shows the engine's frame stats, rebuilt every refresh
+    // interval instead of every frame
+    class FrameStatsComponent : public TextComponent
+    {
+        COMPONENT_2(FrameStatsComponent, TextComponent)
+    public:
+        void LoadProperties(const nlohmann::json& json) override;
+        void Update(float deltaTime) override;
+
+        float GetRefreshInterval() const;
+        void SetRefreshInterval(float seconds);
+
+        // Creates a canvas with the stats in its top left corner. Has to be
+        // called on the main thread, the canvas creates its mesh on init.
+        static GameObject* CreateOverlay(Scene* scene, const std::string& fontPath, int fontSize);
+
+    private:
+        void Refresh();
+
+    private:
+        float m_refreshInterval = 0.5f;
+        float m_timeToRefresh = 0.0f;
+    };
+}
\ No newline at end of file
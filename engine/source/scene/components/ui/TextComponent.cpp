@@ -48,6 +48,14 @@ namespace eng
 
         for (const auto c : m_text)
         {
+            // Lines go down from the pivot
+            if (c == '\n')
+            {
+                xOrigin = pos.x;
+                yOrigin -= static_cast<float>(m_font->GetLineHeight());
+                continue;
+            }
+
             const auto& desc = m_font->GetGlyphDescription(c);
 
             float x1 = static_cast<float>(xOrigin);
@@ -2,6 +2,7 @@
 #include "scene/components/ui/CanvasComponent.h"
 #include "scene/components/ui/UIElementComponent.h"
 #include "Engine.h"
+#include "profiling/Profiler.h"
 
 #include <GLFW/glfw3.h>
 
@@ -19,6 +20,12 @@ namespace eng
 
     void UIInputSystem::SetCanvas(CanvasComponent* canvas)
     {
+        // The handles are only meaningful in the scene of the old canvas
+        if (canvas != m_activeCanvas)
+        {
+            m_hovered = EntityHandle();
+            m_pressed = EntityHandle();
+        }
         m_activeCanvas = canvas;
     }
 
@@ -29,7 +36,9 @@ namespace eng
 
     void UIInputSystem::Update(float deltaTime)
     {
-        if (!m_active || !m_activeCanvas || !m_activeCanvas->IsActive())
+        ENG_PROFILE_SCOPE("UIInputSystem::Update");
+        if (!m_active || !m_activeCanvas || !m_activeCanvas->IsActive() ||
+            !m_activeCanvas->GetOwner()->IsActiveInHierarchy())
         {
             return;
         }
@@ -53,55 +62,66 @@ namespace eng
             }
         }
 
-        if (hit != m_hovered)
+        auto hovered = ResolveElement(m_hovered);
+        auto pressed = ResolveElement(m_pressed);
+
+        if (hit != hovered)
         {
-            if (m_hovered)
+            if (hovered)
             {
-                m_hovered->OnPointerExit();
+                hovered->OnPointerExit();
             }
 
-            m_hovered = hit;
+            hovered = hit;
 
-            if (m_hovered)
+            if (hovered)
             {
-                m_hovered->OnPointerEnter();
+                hovered->OnPointerEnter();
             }
-            m_pressed = nullptr;
+            pressed = nullptr;
         }
 
-        if (!m_pressed)
+        if (!pressed)
         {
-            if (mousePressed && m_hovered)
+            if (mousePressed && hovered)
             {
-                m_pressed = m_hovered;
-                m_pressed->OnPointerDown();
+                pressed = hovered;
+                pressed->OnPointerDown();
             }
         }
 
         if (mouseReleased)
         {
-            if (m_pressed)
+            if (pressed)
             {
-                m_pressed->OnPointerUp();
+                pressed->OnPointerUp();
 
-                if (m_pressed == m_hovered)
+                if (pressed == hovered)
                 {
-                    m_pressed->OnClick();
+                    pressed->OnClick();
                 }
             }
 
-            m_pressed = nullptr;
+            pressed = nullptr;
         }
+
+        m_hovered = hovered ? hovered->GetOwner()->GetHandle() : EntityHandle();
+        m_pressed = pressed ? pressed->GetOwner()->GetHandle() : EntityHandle();
     }
 
-    std::vector<UIElementComponent*> UIInputSystem::CollectUI(CanvasComponent* canvas)
+    FrameVector<UIElementComponent*> UIInputSystem::CollectUI(CanvasComponent* canvas)
     {
-        std::vector<UIElementComponent*> result;
+        FrameVector<UIElementComponent*> result;
         GameObject* canvasObject = canvas->GetOwner();
         const auto& children = canvasObject->GetChildren();
 
         for (const auto& child : children)
         {
+            if (!child->IsActive())
+            {
+                continue;
+            }
+
             if (auto component = child->GetComponent<UIElementComponent>())
             {
                 canvas->CollectUI(component, result);
@@ -110,4 +130,9 @@ namespace eng
         return result;
     }
 
+    UIElementComponent* UIInputSystem::ResolveElement(EntityHandle handle)
+    {
+        auto obj = m_activeCanvas->GetOwner()->GetScene()->Resolve(handle);
+        return obj ? obj->GetComponent<UIElementComponent>() : nullptr;
+    }
 }
\ No newline at end of file
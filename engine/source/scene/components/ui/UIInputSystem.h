@@ -1,5 +1,8 @@
 #pragma once
 
+#include "scene/EntityHandle.h"
+#include "memory/FrameAllocator.h"
+
 #include <vector>
 
 namespace eng
@@ -16,12 +19,17 @@ namespace eng
         CanvasComponent* GetCanvas();
         void Update(float deltaTime);
 
-        std::vector<UIElementComponent*> CollectUI(CanvasComponent* canvas);
+        // Allocated from the frame allocator of the engine
+        FrameVector<UIElementComponent*> CollectUI(CanvasComponent* canvas);
+
+    private:
+        UIElementComponent* ResolveElement(EntityHandle handle);
 
     private:
         bool m_active = false;
         CanvasComponent* m_activeCanvas = nullptr;
-        UIElementComponent* m_hovered = nullptr;
-        UIElementComponent* m_pressed = nullptr;
+        // Owners of the elements, so a destroyed element is never touched
+        EntityHandle m_hovered;
+        EntityHandle m_pressed;
     };
 }
\ No newline at end of file
@@ -22,10 +22,10 @@ bool Game::Init()
     auto& engine = eng::Engine::GetInstance();
     engine.SetScene(m_scene);
 
-    m_3DRoot = m_scene->FindObjectByName("3DRoot");
-    if (m_3DRoot)
+    if (auto root = m_scene->FindObjectByName("3DRoot"))
     {
-        m_3DRoot->SetActive(false);
+        m_3DRoot = root->GetHandle();
+        root->SetActive(false);
     }
 
     auto canvasComponent = engine.GetUIInputSystem().GetCanvas();
@@ -47,9 +47,9 @@ bool Game::Init()
                     engine.GetUIInputSystem().GetCanvas()->SetActive(false);
                     engine.SetCursorEnabled(false);
 
-                    if (m_3DRoot)
+                    if (auto root = m_scene->Resolve(m_3DRoot))
                     {
-                        m_3DRoot->SetActive(true);
+                        root->SetActive(true);
                     }
                 };
         }
@@ -79,11 +79,12 @@ void Game::Update(float deltaTime)
     auto& engine = eng::Engine::GetInstance();
     if (engine.GetInputManager().IsKeyPressed(GLFW_KEY_ESCAPE))
     {
-        if (m_3DRoot && m_3DRoot->IsActive())
+        auto root = m_scene->Resolve(m_3DRoot);
+        if (root && root->IsActive())
         {
             engine.GetUIInputSystem().GetCanvas()->SetActive(true);
             engine.SetCursorEnabled(true);
-            m_3DRoot->SetActive(false);
+            root->SetActive(false);
         }
     }
 }
@@ -12,5 +12,5 @@ public:
 
 private:
     std::shared_ptr<eng::Scene> m_scene;
-    eng::GameObject* m_3DRoot = nullptr;
+    eng::EntityHandle m_3DRoot;
 };
\ No newline at end of file
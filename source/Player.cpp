@@ -54,14 +54,14 @@ void Player::Update(float deltaTime)
             {
                 pos = child->GetWorldPosition();
             }
-            bullet->SetPosition(pos + m_rotation * glm::vec3(-0.2f, 0.2f, -1.75f));
+            bullet->SetPosition(pos + GetRotation() * glm::vec3(-0.2f, 0.2f, -1.75f));
 
             auto collider = std::make_shared<eng::SphereCollider>(0.2f);
             auto rigidBody = std::make_shared<eng::RigidBody>(
                 eng::BodyType::Dynamic, collider, 10.0f, 0.1f);
             bullet->AddComponent(new eng::PhysicsComponent(rigidBody));
 
-            glm::vec3 front = m_rotation * glm::vec3(0.0f, 0.0f, -1.0f);
+            glm::vec3 front = GetRotation() * glm::vec3(0.0f, 0.0f, -1.0f);
             rigidBody->ApplyImpulse(front * 500.0f);
         }
     }
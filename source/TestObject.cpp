@@ -11,9 +11,22 @@ TestObject::TestObject()
 
         out vec3 vColor;
 
+        struct Light
+        {
+            vec3 color;
+            vec3 direction;
+        };
+
+        layout (std140) uniform FrameData
+        {
+            mat4 uView;
+            mat4 uProjection;
+            vec3 uCameraPos;
+            float uTime;
+            Light uLight;
+        };
+
         uniform mat4 uModel;
-        uniform mat4 uView;
-        uniform mat4 uProjection;
 
         void main()
         {
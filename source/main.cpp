@@ -1,15 +1,38 @@
 #include "Game.h"
 #include <eng.h>
 
-int main()
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+int main(int argc, char** argv)
 {
+    // --headless [frames] runs a fixed number of frames without a window
+    // and prints the frame times
+    const bool headless = argc > 1 && std::strcmp(argv[1], "--headless") == 0;
+    const size_t frameCount = headless && argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 600;
+
     Game* game = new Game();
     eng::Engine& engine = eng::Engine::GetInstance();
     engine.SetApplication(game);
 
-    if (engine.Init(1280, 720))
+    if (engine.Init(1280, 720, headless))
     {
-        engine.Run();
+        if (headless)
+        {
+            auto report = engine.Run(frameCount, 1.0f / 60.0f);
+            std::cout << "frames " << report.frames
+                << " min " << report.minMs
+                << " avg " << report.avgMs
+                << " p50 " << report.p50Ms
+                << " p90 " << report.p90Ms
+                << " p99 " << report.p99Ms
+                << " max " << report.maxMs << " ms" << std::endl;
+        }
+        else
+        {
+            engine.Run();
+        }
     }
 
     engine.Destroy();
@@ -0,0 +1,264 @@
+#include "Test.h"
+#include <eng.h>
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+static void FrameStatsReportPoolAllocations()
+{
+    auto& engine = eng::Engine::GetInstance();
+    auto scene = std::make_shared<eng::Scene>();
+    engine.SetScene(scene);
+    engine.Run(1, 1.0f / 60.0f);
+
+    // Counted into the next frame the engine closes
+    for (int i = 0; i < 4; ++i)
+    {
+        auto object = scene->CreateObject("Object");
+        object->AddComponent(new eng::LightComponent());
+    }
+    engine.Run(1, 1.0f / 60.0f);
+
+    const auto& frameStats = engine.GetFrameStats();
+    TEST_CHECK(frameStats.GetFrameAllocations().allocations >= 8);
+    TEST_CHECK(frameStats.GetTotalAllocations().allocations >= frameStats.GetFrameAllocations().allocations);
+
+    // Nothing is created by a frame of an unchanged scene
+    engine.Run(1, 1.0f / 60.0f);
+    TEST_CHECK(frameStats.GetFrameAllocations().allocations == 0);
+
+    engine.SetScene(nullptr);
+}
+
+static void LargeObjectsArePooled()
+{
+    // Above the sizes kept in the fixed table of pools
+    const size_t size = 4000;
+    void* first = eng::ObjectPools::Allocate(size);
+    eng::ObjectPools::Deallocate(first, size);
+
+    const size_t heapAllocations = eng::ObjectPools::GetTotalStats().heapAllocations;
+    void* second = eng::ObjectPools::Allocate(size);
+    TEST_CHECK(second == first);
+    TEST_CHECK(eng::ObjectPools::GetTotalStats().heapAllocations == heapAllocations);
+    eng::ObjectPools::Deallocate(second, size);
+}
+
+static std::shared_ptr<eng::Scene> CreateMeshScene()
+{
+    auto scene = std::make_shared<eng::Scene>();
+    auto camera = scene->CreateObject("Camera");
+    camera->AddComponent(new eng::CameraComponent());
+    camera->SetPosition(glm::vec3(0.0f, 0.0f, 5.0f));
+    scene->SetMainCamera(camera);
+
+    auto object = scene->CreateObject("Mesh");
+    object->AddComponent(new eng::MeshComponent(eng::Material::Load("materials/brick.mat"), eng::Mesh::CreateBox()));
+    return scene;
+}
+
+static void PipelineToggleDropsPendingFrame()
+{
+    auto& engine = eng::Engine::GetInstance();
+    engine.SetScene(CreateMeshScene());
+    engine.SetPipelined(true);
+    eng::NullGraphicsBackend::ResetStats();
+    engine.Run(2, 1.0f / 60.0f);
+    TEST_CHECK(eng::NullGraphicsBackend::GetStats().drawCalls > 0);
+
+    // The frame of the last pipelined update points to the freed mesh
+    engine.SetPipelined(false);
+    engine.SetScene(nullptr);
+    eng::NullGraphicsBackend::ResetStats();
+    engine.Run(1, 1.0f / 60.0f);
+    TEST_CHECK(eng::NullGraphicsBackend::GetStats().drawCalls == 0);
+
+    // Nor may the first pipelined frame draw the last serial one again
+    engine.SetScene(CreateMeshScene());
+    engine.Run(1, 1.0f / 60.0f);
+    engine.SetScene(nullptr);
+    engine.SetPipelined(true);
+    eng::NullGraphicsBackend::ResetStats();
+    engine.Run(1, 1.0f / 60.0f);
+    TEST_CHECK(eng::NullGraphicsBackend::GetStats().drawCalls == 0);
+
+    engine.SetPipelined(false);
+}
+
+static eng::Scene* s_sceneAfterSwitch = nullptr;
+
+// Switches to another scene from its update, like a level exit
+class SceneSwitchComponent final : public eng::Component
+{
+    COMPONENT_SYSTEM(SceneSwitchComponent, eng::UpdatePhase::Early)
+public:
+    void Update(float deltaTime) override
+    {
+        auto& engine = eng::Engine::GetInstance();
+        engine.SetScene(nullptr);
+        s_sceneAfterSwitch = engine.GetScene().get();
+    }
+};
+
+static void PipelinedSceneSwitchWaitsForTheDraw()
+{
+    auto& engine = eng::Engine::GetInstance();
+    auto scene = CreateMeshScene();
+    scene->CreateObject("Switch")->AddComponent(new SceneSwitchComponent());
+    eng::Scene* oldScene = scene.get();
+    std::weak_ptr<eng::Scene> weakScene = scene;
+    engine.SetScene(scene);
+    scene = nullptr;
+
+    // The update switches while the main thread draws, the old scene has
+    // to live until the frame is over
+    engine.SetPipelined(true);
+    engine.Run(1, 1.0f / 60.0f);
+    TEST_CHECK(s_sceneAfterSwitch == oldScene);
+    TEST_CHECK(weakScene.expired());
+    TEST_CHECK(engine.GetScene() == nullptr);
+
+    // And its frame is not drawn after it is gone
+    eng::NullGraphicsBackend::ResetStats();
+    engine.Run(1, 1.0f / 60.0f);
+    TEST_CHECK(eng::NullGraphicsBackend::GetStats().drawCalls == 0);
+
+    engine.SetPipelined(false);
+}
+
+// Drops the last reference to a texture from its update, like replacing
+// a material does
+class TextureReleaseComponent final : public eng::Component
+{
+    COMPONENT_SYSTEM(TextureReleaseComponent, eng::UpdatePhase::Early)
+public:
+    void Update(float deltaTime) override
+    {
+        texture.reset();
+    }
+
+    std::shared_ptr<eng::Texture> texture;
+};
+
+static void PipelinedUpdateCanReleaseTextures()
+{
+    auto& engine = eng::Engine::GetInstance();
+    auto scene = std::make_shared<eng::Scene>();
+    unsigned char pixel[4] = { 255, 255, 255, 255 };
+    auto component = new TextureReleaseComponent();
+    component->texture = std::make_shared<eng::Texture>(1, 1, 4, pixel);
+    std::weak_ptr<eng::Texture> weakTexture = component->texture;
+    scene->CreateObject("Release")->AddComponent(component);
+    engine.SetScene(scene);
+
+    // The GL delete waits for the main thread instead of failing the run
+    engine.SetPipelined(true);
+    engine.Run(1, 1.0f / 60.0f);
+    TEST_CHECK(weakTexture.expired());
+
+    engine.SetPipelined(false);
+    engine.SetScene(nullptr);
+}
+
+// Records the step lengths the scene is updated with
+class StepLogComponent final : public eng::Component
+{
+    COMPONENT_SYSTEM(StepLogComponent, eng::UpdatePhase::Early)
+public:
+    void Update(float deltaTime) override
+    {
+        steps.push_back(deltaTime);
+    }
+
+    std::vector<float> steps;
+};
+
+static void FixedStepsAccumulateAndClamp()
+{
+    auto& engine = eng::Engine::GetInstance();
+    auto scene = std::make_shared<eng::Scene>();
+    auto component = new StepLogComponent();
+    scene->CreateObject("Steps")->AddComponent(component);
+    engine.SetScene(scene);
+
+    const float step = 1.0f / 60.0f;
+    engine.SetFixedTimestep(step, 3);
+
+    // Less than a step runs nothing and carries over
+    engine.Run(1, step * 0.5f);
+    TEST_CHECK(component->steps.empty());
+    TEST_CHECK(std::abs(engine.GetInterpolationAlpha() - 0.5f) < 1e-3f);
+
+    engine.Run(1, step * 1.75f);
+    TEST_CHECK(component->steps == std::vector<float>({ step, step }));
+    TEST_CHECK(std::abs(engine.GetInterpolationAlpha() - 0.25f) < 1e-3f);
+
+    // A long frame runs maxSteps and drops the whole steps left over
+    component->steps.clear();
+    engine.Run(1, step * 10.5f);
+    TEST_CHECK(component->steps.size() == 3);
+    TEST_CHECK(std::abs(engine.GetInterpolationAlpha() - 0.75f) < 1e-3f);
+
+    component->steps.clear();
+    engine.Run(1, step * 0.5f);
+    TEST_CHECK(component->steps.size() == 1);
+
+    // Back to one step per frame
+    engine.SetFixedTimestep(0.0f);
+    component->steps.clear();
+    engine.Run(1, step * 0.5f);
+    TEST_CHECK(component->steps == std::vector<float>({ step * 0.5f }));
+    TEST_CHECK(engine.GetInterpolationAlpha() == 1.0f);
+
+    engine.SetScene(nullptr);
+}
+
+static void FrameArenasStopAllocatingAfterWarmUp()
+{
+    // Blocks grown during a frame are merged on reset, so the same frame
+    // again fits in the memory kept
+    eng::FrameArena arena(1024);
+    for (int i = 0; i < 8; ++i)
+    {
+        arena.Allocate(700, 16);
+    }
+    TEST_CHECK(arena.GetHeapAllocations() == 8);
+    arena.Reset();
+    void* first = arena.Allocate(700, 16);
+    for (int i = 1; i < 8; ++i)
+    {
+        arena.Allocate(700, 16);
+    }
+    TEST_CHECK(arena.GetHeapAllocations() == 0);
+    arena.Reset();
+    TEST_CHECK(arena.Allocate(700, 16) == first);
+
+    // Frames of an unchanged scene, after both sets of arenas are warm
+    auto& engine = eng::Engine::GetInstance();
+    auto scene = CreateMeshScene();
+    scene->CreateObject("Light")->AddComponent(new eng::LightComponent());
+    engine.SetScene(scene);
+    engine.Run(4, 1.0f / 60.0f);
+    for (int i = 0; i < 3; ++i)
+    {
+        engine.Run(1, 1.0f / 60.0f);
+        TEST_CHECK(engine.GetFrameAllocator().GetLastFrameHeapAllocations() == 0);
+    }
+
+    engine.SetScene(nullptr);
+}
+
+void RegisterFrameTests(TestRunner& runner)
+{
+    SceneSwitchComponent::Register();
+    TextureReleaseComponent::Register();
+    StepLogComponent::Register();
+    runner.Add("Frame/FrameStatsReportPoolAllocations", FrameStatsReportPoolAllocations);
+    runner.Add("Frame/LargeObjectsArePooled", LargeObjectsArePooled);
+    runner.Add("Frame/PipelineToggleDropsPendingFrame", PipelineToggleDropsPendingFrame);
+    runner.Add("Frame/PipelinedSceneSwitchWaitsForTheDraw", PipelinedSceneSwitchWaitsForTheDraw);
+    runner.Add("Frame/PipelinedUpdateCanReleaseTextures", PipelinedUpdateCanReleaseTextures);
+    runner.Add("Frame/FixedStepsAccumulateAndClamp", FixedStepsAccumulateAndClamp);
+    runner.Add("Frame/FrameArenasStopAllocatingAfterWarmUp", FrameArenasStopAllocatingAfterWarmUp);
+}
\ No newline at end of file
@@ -0,0 +1,155 @@
+#include "Test.h"
+#include <eng.h>
+
+#include <iostream>
+#include <sstream>
+
+static void HeadlessProgramsReportDeclaredUniforms()
+{
+    const std::string vertexSource = R"(
+        #version 330 core
+        layout (location = 0) in vec3 position;
+        layout (std140) uniform FrameData
+        {
+            mat4 view;
+        };
+        uniform mat4 uModel;
+        // uniform mat4 uCommented;
+        uniform vec2 uOffsets[4], uScale;
+        void main()
+        {
+            gl_Position = view * uModel * vec4(position * vec3(uScale, 1.0) + vec3(uOffsets[0], 0.0), 1.0);
+        }
+    )";
+    const std::string fragmentSource = R"(
+        #version 330 core
+        out vec4 FragColor;
+        uniform mat4 uModel;
+        uniform vec4 uColor;
+        void main()
+        {
+            FragColor = uColor;
+        }
+    )";
+
+    auto& graphicsAPI = eng::Engine::GetInstance().GetGraphicsAPI();
+    auto program = graphicsAPI.CreateShaderProgram(vertexSource, fragmentSource);
+    TEST_CHECK(program != nullptr);
+    if (!program)
+    {
+        return;
+    }
+
+    TEST_CHECK(program->GetUniformLocation("uModel") >= 0);
+    TEST_CHECK(program->GetUniformLocation("uColor") >= 0);
+    TEST_CHECK(program->GetUniformLocation("uScale") >= 0);
+    TEST_CHECK(program->GetUniformLocation("uOffsets") >= 0);
+    TEST_CHECK(program->GetUniformLocation("uOffsets") == program->GetUniformLocation("uOffsets[0]"));
+    // Every element of an array is found, not only the first
+    TEST_CHECK(program->GetUniformLocation("uOffsets[3]") >= 0);
+    TEST_CHECK(program->GetUniformLocation("uOffsets[3]") != program->GetUniformLocation("uOffsets[0]"));
+    TEST_CHECK(program->GetUniformLocation("uOffsets[4]") < 0);
+    TEST_CHECK(program->GetUniformLocation("uModel") != program->GetUniformLocation("uColor"));
+    // Block members and commented out declarations are not uniforms
+    TEST_CHECK(program->GetUniformLocation("view") < 0);
+    TEST_CHECK(program->GetUniformLocation("uCommented") < 0);
+}
+
+static void UniformHashCollisionsAreToldApart()
+{
+    // "costarring" and "liquid" have the same FNV-1a hash
+    const std::string vertexSource = R"(
+        #version 330 core
+        layout (location = 0) in vec3 position;
+        uniform float costarring;
+        uniform float liquid;
+        void main()
+        {
+            gl_Position = vec4(position * costarring * liquid, 1.0);
+        }
+    )";
+    const std::string fragmentSource = R"(
+        #version 330 core
+        out vec4 FragColor;
+        void main()
+        {
+            FragColor = vec4(1.0);
+        }
+    )";
+
+    std::ostringstream errors;
+    auto previous = std::cerr.rdbuf(errors.rdbuf());
+    auto program = eng::Engine::GetInstance().GetGraphicsAPI().CreateShaderProgram(vertexSource, fragmentSource);
+    std::cerr.rdbuf(previous);
+
+    TEST_CHECK(program != nullptr);
+    if (!program)
+    {
+        return;
+    }
+
+    // The check hash keeps them apart, so nothing is reported
+    TEST_CHECK(errors.str().find("UNIFORM_HASH_COLLISION") == std::string::npos);
+    TEST_CHECK(program->GetUniformLocation("costarring") >= 0);
+    TEST_CHECK(program->GetUniformLocation("liquid") >= 0);
+    TEST_CHECK(program->GetUniformLocation("costarring") != program->GetUniformLocation("liquid"));
+
+    // Nor does a query match a different uniform with the same hash
+    const std::string singleSource = R"(
+        #version 330 core
+        layout (location = 0) in vec3 position;
+        uniform float costarring;
+        void main()
+        {
+            gl_Position = vec4(position * costarring, 1.0);
+        }
+    )";
+    auto single = eng::Engine::GetInstance().GetGraphicsAPI().CreateShaderProgram(singleSource, fragmentSource);
+    TEST_CHECK(single != nullptr);
+    if (single)
+    {
+        TEST_CHECK(single->GetUniformLocation("costarring") >= 0);
+        TEST_CHECK(single->GetUniformLocation("liquid") < 0);
+    }
+}
+
+static void MaterialParamsAreKeptById()
+{
+    const std::string vertexSource = R"(
+        #version 330 core
+        layout (location = 0) in vec3 position;
+        void main()
+        {
+            gl_Position = vec4(position, 1.0);
+        }
+    )";
+    const std::string fragmentSource = R"(
+        #version 330 core
+        out vec4 FragColor;
+        uniform float uAlpha;
+        uniform vec3 uColor;
+        void main()
+        {
+            FragColor = vec4(uColor, uAlpha);
+        }
+    )";
+
+    auto program = eng::Engine::GetInstance().GetGraphicsAPI().CreateShaderProgram(vertexSource, fragmentSource);
+    eng::Material material;
+    material.SetShaderProgram(program);
+    material.SetParam("uAlpha", 0.5f);
+    material.SetParam(std::string("uAlpha"), 1.0f);
+    material.SetParam("uColor", glm::vec3(1.0f));
+
+    // Setting a param again replaces it, one upload per param
+    eng::NullGraphicsBackend::ResetStats();
+    material.Bind();
+    TEST_CHECK(eng::NullGraphicsBackend::GetStats().uniformUploads == 2);
+}
+
+void RegisterGraphicsTests(TestRunner& runner)
+{
+    runner.Add("Graphics/HeadlessProgramsReportDeclaredUniforms", HeadlessProgramsReportDeclaredUniforms);
+    runner.Add("Graphics/UniformHashCollisionsAreToldApart", UniformHashCollisionsAreToldApart);
+    runner.Add("Graphics/MaterialParamsAreKeptById", MaterialParamsAreKeptById);
+}
\ No newline at end of file
@@ -0,0 +1,175 @@
+#include "Test.h"
+#include <eng.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+static eng::RenderCommand MakeCommand(eng::Mesh* mesh, eng::Material* material, const glm::vec3& position)
+{
+    eng::RenderCommand command;
+    command.mesh = mesh;
+    command.material = material;
+    command.modelMatrix = glm::translate(glm::mat4(1.0f), position);
+    return command;
+}
+
+// Builds and draws one frame of the commands, the camera at the origin
+static void DrawFrame(eng::RenderQueue& renderQueue, const std::vector<eng::RenderCommand>& commands)
+{
+    for (const auto& command : commands)
+    {
+        renderQueue.Submit(command);
+    }
+    renderQueue.EndFrame(eng::CameraData(), eng::FrameVector<eng::LightData>());
+    renderQueue.SwapFrames();
+    renderQueue.Draw(eng::Engine::GetInstance().GetGraphicsAPI());
+}
+
+static void EqualKeysKeepSubmitOrder()
+{
+    eng::RenderQueue renderQueue;
+    renderQueue.Init();
+    renderQueue.SetCullingEnabled(false);
+    auto material = eng::Material::Load("materials/brick.mat");
+    auto mesh = eng::Mesh::CreateBox();
+
+    // All at the same distance but the last one, so only that one sorts
+    // away from its submit position
+    const std::vector<glm::vec3> positions =
+    {
+        glm::vec3(2.0f, 0.0f, 0.0f),
+        glm::vec3(0.0f, 2.0f, 0.0f),
+        glm::vec3(-2.0f, 0.0f, 0.0f),
+        glm::vec3(0.0f, -2.0f, 0.0f),
+        glm::vec3(0.0f, 0.0f, 2.0f),
+        glm::vec3(0.0f, 0.0f, -1.0f)
+    };
+    std::vector<eng::RenderCommand> commands;
+    for (const auto& position : positions)
+    {
+        commands.push_back(MakeCommand(mesh.get(), material.get(), position));
+    }
+    DrawFrame(renderQueue, commands);
+
+    const auto& stats = renderQueue.GetStats();
+    TEST_CHECK(stats.instancedDraws == 1);
+    TEST_CHECK(stats.instances == positions.size());
+
+    // The instance matrices are uploaded in draw order
+    const auto& data = eng::NullGraphicsBackend::GetLastBufferData();
+    TEST_CHECK(data.size() == positions.size() * sizeof(glm::mat4));
+    if (data.size() != positions.size() * sizeof(glm::mat4))
+    {
+        return;
+    }
+    std::vector<glm::mat4> instances(positions.size());
+    std::memcpy(instances.data(), data.data(), data.size());
+
+    const std::vector<glm::vec3> expected =
+    {
+        positions[5], positions[0], positions[1], positions[2], positions[3], positions[4]
+    };
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        TEST_CHECK(glm::vec3(instances[i][3]) == expected[i]);
+    }
+}
+
+static void RunsOfMeshAndMaterialAreBatched()
+{
+    eng::RenderQueue renderQueue;
+    renderQueue.Init();
+    renderQueue.SetCullingEnabled(false);
+    auto brick = eng::Material::Load("materials/brick.mat");
+    auto checker = eng::Material::Load("materials/checker.mat");
+    auto box = eng::Mesh::CreateBox();
+    auto sphere = eng::Mesh::CreateSphere(1.0f, 8, 8);
+
+    // Interleaved, sorting has to group them: three boxes of brick, two
+    // of checker and a single brick sphere
+    const glm::vec3 position(0.0f, 0.0f, -5.0f);
+    const std::vector<eng::RenderCommand> commands =
+    {
+        MakeCommand(box.get(), brick.get(), position),
+        MakeCommand(box.get(), checker.get(), position),
+        MakeCommand(sphere.get(), brick.get(), position),
+        MakeCommand(box.get(), brick.get(), position),
+        MakeCommand(box.get(), checker.get(), position),
+        MakeCommand(box.get(), brick.get(), position)
+    };
+    eng::NullGraphicsBackend::ResetStats();
+    DrawFrame(renderQueue, commands);
+
+    // A run of MinInstances is instanced, a shorter one is drawn alone
+    const auto& stats = renderQueue.GetStats();
+    TEST_CHECK(stats.visibleCommands == commands.size());
+    TEST_CHECK(stats.drawCalls == 3);
+    TEST_CHECK(stats.instancedDraws == 2);
+    TEST_CHECK(stats.instances == 5);
+    TEST_CHECK(stats.meshChanges == 3);
+    TEST_CHECK(eng::NullGraphicsBackend::GetStats().instancesDrawn == 5);
+}
+
+static void DynamicMeshesUpdateTheirBounds()
+{
+    auto mesh = eng::Mesh::CreateBox();
+
+    // Two vertices of the box layout, position first
+    std::vector<float> vertices(22, 0.0f);
+    vertices[0] = 10.0f;
+    vertices[11] = 12.0f;
+    mesh->UpdateDynamic(vertices);
+
+    const auto& sphere = mesh->GetBoundingSphere();
+    TEST_CHECK(sphere.center == glm::vec3(11.0f, 0.0f, 0.0f));
+    TEST_CHECK(sphere.radius == 1.0f);
+    TEST_CHECK(mesh->GetBounds().max == glm::vec3(12.0f, 0.0f, 0.0f));
+
+    // Uploads that skip the bounds leave the mesh unbounded, not stale
+    mesh->UpdateDynamic(vertices, false);
+    TEST_CHECK(std::isinf(mesh->GetBoundingSphere().radius));
+    mesh->UpdateDynamic(vertices);
+    TEST_CHECK(mesh->GetBoundingSphere().radius == 1.0f);
+}
+
+// Uniform uploads of a frame with the given number of sprites
+static size_t CountSpriteUploads(eng::RenderQueue& renderQueue, eng::Texture* texture, size_t spriteCount)
+{
+    eng::RenderCommand2D command;
+    command.texture = texture;
+    for (size_t i = 0; i < spriteCount; ++i)
+    {
+        renderQueue.Submit(command);
+    }
+    renderQueue.EndFrame(eng::CameraData(), eng::FrameVector<eng::LightData>());
+    renderQueue.SwapFrames();
+    eng::NullGraphicsBackend::ResetStats();
+    renderQueue.Draw(eng::Engine::GetInstance().GetGraphicsAPI());
+    return eng::NullGraphicsBackend::GetStats().uniformUploads;
+}
+
+static void SpriteViewAndProjectionAreUploadedOnce()
+{
+    eng::RenderQueue renderQueue;
+    renderQueue.Init();
+    unsigned char pixel[4] = { 255, 255, 255, 255 };
+    eng::Texture texture(1, 1, 4, pixel);
+
+    // Whatever a sprite uploads, view and projection are not part of it
+    const size_t oneSprite = CountSpriteUploads(renderQueue, &texture, 1);
+    const size_t twoSprites = CountSpriteUploads(renderQueue, &texture, 2);
+    const size_t perSprite = twoSprites - oneSprite;
+    TEST_CHECK(oneSprite - perSprite == 2);
+}
+
+void RegisterRenderTests(TestRunner& runner)
+{
+    runner.Add("Render/EqualKeysKeepSubmitOrder", EqualKeysKeepSubmitOrder);
+    runner.Add("Render/RunsOfMeshAndMaterialAreBatched", RunsOfMeshAndMaterialAreBatched);
+    runner.Add("Render/SpriteViewAndProjectionAreUploadedOnce", SpriteViewAndProjectionAreUploadedOnce);
+    runner.Add("Render/DynamicMeshesUpdateTheirBounds", DynamicMeshesUpdateTheirBounds);
+}
\ No newline at end of file
@@ -0,0 +1,496 @@
+#include "Test.h"
+#include <eng.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <cmath>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// Early system component that logs its updates in hierarchy order
+class LoggingComponent final : public eng::Component
+{
+    COMPONENT_SYSTEM_ORDERED(LoggingComponent, eng::UpdatePhase::Early, eng::SystemOrder::Hierarchy)
+public:
+    void Update(float deltaTime) override
+    {
+        ++updates;
+        if (log)
+        {
+            log->push_back(this);
+        }
+    }
+
+    int updates = 0;
+    std::vector<LoggingComponent*>* log = nullptr;
+};
+
+static void RenameKeepsSystemComponents()
+{
+    auto scene = std::make_shared<eng::Scene>();
+    auto object = scene->CreateObject("Object");
+    auto component = new LoggingComponent();
+    object->AddComponent(component);
+
+    object->SetName("Renamed");
+    scene->Update(1.0f / 60.0f);
+
+    TEST_CHECK(component->updates == 1);
+    TEST_CHECK(scene->FindObjectByName("Renamed") == object);
+    TEST_CHECK(scene->FindObjectByName("Object") == nullptr);
+}
+
+static void DestroyedObjectsAreNotFoundByName()
+{
+    auto& engine = eng::Engine::GetInstance();
+    auto scene = std::make_shared<eng::Scene>();
+    auto parent = scene->CreateObject("Parent");
+    scene->CreateObject("Child", parent);
+
+    parent->MarkForDestroy();
+    TEST_CHECK(scene->FindObjectByName("Parent") == nullptr);
+
+    // A pipelined engine keeps the retired objects until the draw is done,
+    // detached from the tree
+    engine.SetPipelined(true);
+    scene->Update(1.0f / 60.0f);
+    engine.SetPipelined(false);
+    TEST_CHECK(scene->FindObjectByName("Parent") == nullptr);
+    TEST_CHECK(scene->FindObjectByName("Child") == nullptr);
+
+    auto other = scene->CreateObject("Child");
+    TEST_CHECK(scene->FindObjectByName("Child") == other);
+    scene->ReleaseDestroyedObjects();
+}
+
+static void NameLookupsFollowTreeOrder()
+{
+    auto scene = std::make_shared<eng::Scene>();
+    auto first = scene->CreateObject("First");
+    auto second = scene->CreateObject("Second");
+    auto inSecond = scene->CreateObject("Target", second);
+    auto arm = scene->CreateObject("Arm", first);
+    auto shallow = scene->CreateObject("Target", first);
+    auto deep = scene->CreateObject("Target", arm);
+
+    // Depth first like a walk of the tree, not the order of creation
+    TEST_CHECK(scene->FindObjectByName("Target") == deep);
+    TEST_CHECK(first->FindChildByName("Target") == deep);
+    TEST_CHECK(arm->FindChildByName("Target") == deep);
+    TEST_CHECK(second->FindChildByName("Target") == inSecond);
+    TEST_CHECK(shallow->FindChildByName("Target") == shallow);
+    TEST_CHECK(second->FindChildByName("Arm") == nullptr);
+
+    // Reparenting changes the order
+    scene->SetParent(first, second);
+    TEST_CHECK(scene->FindObjectByName("Target") == inSecond);
+    TEST_CHECK(first->FindChildByName("Target") == deep);
+    scene->SetParent(arm, nullptr);
+    TEST_CHECK(first->FindChildByName("Target") == shallow);
+}
+
+static void SystemsRunInHierarchyOrder()
+{
+    auto scene = std::make_shared<eng::Scene>();
+    auto first = scene->CreateObject("First");
+    auto second = scene->CreateObject("Second");
+    auto child = scene->CreateObject("Child", second);
+
+    // Added in reverse order of the hierarchy
+    std::vector<LoggingComponent*> log;
+    std::vector<LoggingComponent*> components;
+    for (auto object : { child, second, first })
+    {
+        auto component = new LoggingComponent();
+        component->log = &log;
+        object->AddComponent(component);
+        components.push_back(component);
+    }
+
+    scene->Update(1.0f / 60.0f);
+    TEST_CHECK(log.size() == 3);
+    TEST_CHECK(log == std::vector<LoggingComponent*>({ components[2], components[1], components[0] }));
+
+    // Moving the child to the first root puts it before the second root
+    log.clear();
+    scene->SetParent(child, first);
+    scene->Update(1.0f / 60.0f);
+    TEST_CHECK(log == std::vector<LoggingComponent*>({ components[2], components[0], components[1] }));
+}
+
+static void InactiveSubtreesAreSkipped()
+{
+    auto scene = std::make_shared<eng::Scene>();
+    auto root = scene->CreateObject("Root");
+    auto child = scene->CreateObject("Child", root);
+    auto grandchild = scene->CreateObject("Grandchild", child);
+    auto component = new LoggingComponent();
+    grandchild->AddComponent(component);
+
+    root->SetActive(false);
+    TEST_CHECK(grandchild->IsActive());
+    TEST_CHECK(!child->IsActiveInHierarchy());
+    TEST_CHECK(!grandchild->IsActiveInHierarchy());
+    scene->Update(1.0f / 60.0f);
+    TEST_CHECK(component->updates == 0);
+
+    // Moving out of the inactive subtree activates it again
+    auto other = scene->CreateObject("Other");
+    scene->SetParent(child, other);
+    TEST_CHECK(grandchild->IsActiveInHierarchy());
+    scene->Update(1.0f / 60.0f);
+    TEST_CHECK(component->updates == 1);
+
+    // An own inactive flag wins over an active parent
+    scene->SetParent(child, root);
+    root->SetActive(true);
+    child->SetActive(false);
+    TEST_CHECK(root->IsActiveInHierarchy());
+    TEST_CHECK(!grandchild->IsActiveInHierarchy());
+    scene->Update(1.0f / 60.0f);
+    TEST_CHECK(component->updates == 1);
+
+    child->SetActive(true);
+    TEST_CHECK(grandchild->IsActiveInHierarchy());
+    scene->Update(1.0f / 60.0f);
+    TEST_CHECK(component->updates == 2);
+}
+
+// Reparents from its update, like gameplay code does
+class ReparentComponent final : public eng::Component
+{
+    COMPONENT_SYSTEM(ReparentComponent, eng::UpdatePhase::Early)
+public:
+    void Update(float deltaTime) override
+    {
+        results.push_back(GetOwner()->GetScene()->SetParent(GetOwner(), parent));
+        if (thenBackTo)
+        {
+            results.push_back(GetOwner()->GetScene()->SetParent(GetOwner(), thenBackTo));
+        }
+    }
+
+    eng::GameObject* parent = nullptr;
+    // Second move in the same update
+    eng::GameObject* thenBackTo = nullptr;
+    std::vector<bool> results;
+};
+
+static void SetParentDuringUpdateIsValidated()
+{
+    auto scene = std::make_shared<eng::Scene>();
+    auto root = scene->CreateObject("Root");
+    auto child = scene->CreateObject("Child", root);
+
+    // A cycle is refused right away instead of when the update is over
+    auto component = new ReparentComponent();
+    component->parent = child;
+    root->AddComponent(component);
+    scene->Update(1.0f / 60.0f);
+    TEST_CHECK(component->results == std::vector<bool>({ false }));
+    TEST_CHECK(child->GetParent() == root);
+    TEST_CHECK(root->GetParent() == nullptr);
+
+    // A valid change is applied after the update
+    auto other = scene->CreateObject("Other");
+    component->parent = other;
+    scene->Update(1.0f / 60.0f);
+    TEST_CHECK(component->results == std::vector<bool>({ false, true }));
+    TEST_CHECK(root->GetParent() == other);
+
+    // Moving under the current parent is refused too
+    scene->Update(1.0f / 60.0f);
+    TEST_CHECK(component->results == std::vector<bool>({ false, true, false }));
+}
+
+static void SetParentDuringUpdateSeesQueuedChanges()
+{
+    auto scene = std::make_shared<eng::Scene>();
+    auto first = scene->CreateObject("First");
+    auto second = scene->CreateObject("Second");
+    auto child = scene->CreateObject("Child", first);
+
+    // Moving away and back in one update ends where it started
+    auto component = new ReparentComponent();
+    component->parent = second;
+    component->thenBackTo = first;
+    child->AddComponent(component);
+    scene->Update(1.0f / 60.0f);
+    TEST_CHECK(component->results == std::vector<bool>({ true, true }));
+    TEST_CHECK(child->GetParent() == first);
+
+    // Moving twice to the same parent is refused the second time
+    component->thenBackTo = second;
+    scene->Update(1.0f / 60.0f);
+    TEST_CHECK(component->results == std::vector<bool>({ true, true, true, false }));
+    TEST_CHECK(child->GetParent() == second);
+
+    // A queued move counts for the cycle check: x is going below y, so y
+    // can't go below x
+    auto x = scene->CreateObject("X");
+    auto y = scene->CreateObject("Y");
+    auto xMover = new ReparentComponent();
+    xMover->parent = y;
+    x->AddComponent(xMover);
+    auto yMover = new ReparentComponent();
+    yMover->parent = x;
+    y->AddComponent(yMover);
+    scene->Update(1.0f / 60.0f);
+    TEST_CHECK(xMover->results == std::vector<bool>({ true }));
+    TEST_CHECK(yMover->results == std::vector<bool>({ false }));
+    TEST_CHECK(x->GetParent() == y);
+    TEST_CHECK(y->GetParent() == nullptr);
+}
+
+static void StaleHandlesDoNotResolveReusedSlots()
+{
+    auto scene = std::make_shared<eng::Scene>();
+    auto object = scene->CreateObject("Object");
+    const auto handle = object->GetHandle();
+    TEST_CHECK(scene->Resolve(handle) == object);
+
+    object->MarkForDestroy();
+    scene->Update(1.0f / 60.0f);
+
+    // The new object takes the freed slot with the next generation
+    auto reuse = scene->CreateObject("Reuse");
+    const auto reuseHandle = reuse->GetHandle();
+    TEST_CHECK(reuseHandle.index == handle.index);
+    TEST_CHECK(reuseHandle.generation != handle.generation);
+    TEST_CHECK(scene->Resolve(handle) == nullptr);
+    TEST_CHECK(scene->Resolve(reuseHandle) == reuse);
+}
+
+static void MarkedObjectsDoNotResolve()
+{
+    auto& engine = eng::Engine::GetInstance();
+    auto scene = std::make_shared<eng::Scene>();
+    auto parent = scene->CreateObject("Parent");
+    auto child = scene->CreateObject("Child", parent);
+    const auto parentHandle = parent->GetHandle();
+    const auto childHandle = child->GetHandle();
+
+    // Right away, not only once the object is gone
+    parent->MarkForDestroy();
+    TEST_CHECK(scene->Resolve(parentHandle) == nullptr);
+
+    // A pipelined engine keeps the objects until the draw is done, they
+    // and their children must not resolve in the meantime
+    engine.SetPipelined(true);
+    scene->Update(1.0f / 60.0f);
+    engine.SetPipelined(false);
+    TEST_CHECK(scene->Resolve(parentHandle) == nullptr);
+    TEST_CHECK(scene->Resolve(childHandle) == nullptr);
+
+    scene->ReleaseDestroyedObjects();
+    auto reuse = scene->CreateObject("Reuse");
+    TEST_CHECK(scene->Resolve(parentHandle) == nullptr);
+    TEST_CHECK(scene->Resolve(childHandle) == nullptr);
+    TEST_CHECK(scene->Resolve(reuse->GetHandle()) == reuse);
+}
+
+// Creates an object from its update and tries to resolve it right away
+class SpawnComponent final : public eng::Component
+{
+    COMPONENT_SYSTEM(SpawnComponent, eng::UpdatePhase::Early)
+public:
+    void Update(float deltaTime) override
+    {
+        auto scene = GetOwner()->GetScene();
+        auto object = scene->CreateObject("Spawned");
+        spawned.push_back(object);
+        handles.push_back(object->GetHandle());
+        resolvedDuringUpdate.push_back(scene->Resolve(object->GetHandle()));
+    }
+
+    std::vector<eng::GameObject*> spawned;
+    std::vector<eng::EntityHandle> handles;
+    std::vector<eng::GameObject*> resolvedDuringUpdate;
+};
+
+static void ObjectsCreatedDuringUpdateResolveAfterIt()
+{
+    auto scene = std::make_shared<eng::Scene>();
+    auto spawner = scene->CreateObject("Spawner");
+    auto component = new SpawnComponent();
+    spawner->AddComponent(component);
+
+    scene->Update(1.0f / 60.0f);
+    TEST_CHECK(component->resolvedDuringUpdate == std::vector<eng::GameObject*>({ nullptr }));
+    if (component->handles.size() != 1)
+    {
+        return;
+    }
+    TEST_CHECK(scene->Resolve(component->handles[0]) == component->spawned[0]);
+
+    // Also when the new object reuses the slot of a destroyed one
+    const auto staleHandle = component->handles[0];
+    component->spawned[0]->MarkForDestroy();
+    scene->Update(1.0f / 60.0f);
+    TEST_CHECK(component->handles.size() == 2);
+    if (component->handles.size() != 2)
+    {
+        return;
+    }
+    TEST_CHECK(component->handles[0] != component->handles[1]);
+    TEST_CHECK(scene->Resolve(component->handles[1]) == component->spawned[1]);
+
+    scene->Update(1.0f / 60.0f);
+    TEST_CHECK(component->handles.size() == 3);
+    if (component->handles.size() != 3)
+    {
+        return;
+    }
+    TEST_CHECK(component->handles[2].index == staleHandle.index);
+    TEST_CHECK(component->resolvedDuringUpdate[2] == nullptr);
+    TEST_CHECK(scene->Resolve(staleHandle) == nullptr);
+    TEST_CHECK(scene->Resolve(component->handles[2]) == component->spawned[2]);
+}
+
+static bool NearlyEqual(const glm::mat4& a, const glm::mat4& b)
+{
+    for (int c = 0; c < 4; ++c)
+    {
+        for (int r = 0; r < 4; ++r)
+        {
+            if (std::abs(a[c][r] - b[c][r]) > 1e-4f)
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static void WorldTransformsAreSweptIn2D()
+{
+    eng::TransformStore store;
+    const uint32_t parent = store.Create();
+    const uint32_t child = store.Create();
+    store.SetParent(child, parent);
+    store.SetPosition(parent, glm::vec3(3.0f, -2.0f, 1.0f));
+    store.SetRotation(parent, glm::angleAxis(glm::radians(30.0f), glm::vec3(0.0f, 0.0f, 1.0f)));
+    store.SetScale(parent, glm::vec3(2.0f, 1.0f, 1.0f));
+    store.SetPosition(child, glm::vec3(1.0f, 0.0f, 0.0f));
+    store.SetRotation(child, glm::angleAxis(glm::radians(200.0f), glm::vec3(0.0f, 0.0f, 1.0f)));
+    store.UpdateWorldTransforms();
+
+    // Same matrices as translate * rotate(angle) * scale
+    auto reference = [](const glm::vec3& pos, const glm::quat& rot, const glm::vec3& scale)
+        {
+            glm::mat4 mat = glm::translate(glm::mat4(1.0f), glm::vec3(pos.x, pos.y, 0.0f));
+            mat = glm::rotate(mat, glm::angle(rot), glm::vec3(0.0f, 0.0f, 1.0f));
+            return glm::scale(mat, glm::vec3(scale.x, scale.y, 1.0f));
+        };
+    const glm::mat4 parentWorld = reference(store.GetPosition(parent), store.GetRotation(parent), store.GetScale(parent));
+    const glm::mat4 childWorld = parentWorld * reference(store.GetPosition(child), store.GetRotation(child), store.GetScale(child));
+    TEST_CHECK(NearlyEqual(store.GetWorldTransform2D(parent), parentWorld));
+    TEST_CHECK(NearlyEqual(store.GetWorldTransform2D(child), childWorld));
+
+    // A moved parent updates the 2D matrix of its child in the sweep too
+    store.SetPosition(parent, glm::vec3(-1.0f, 4.0f, 0.0f));
+    store.MarkDirty(parent);
+    store.MarkDirty(child);
+    store.UpdateWorldTransforms();
+    TEST_CHECK(NearlyEqual(store.GetWorldTransform2D(child),
+        reference(store.GetPosition(parent), store.GetRotation(parent), store.GetScale(parent)) *
+        reference(store.GetPosition(child), store.GetRotation(child), store.GetScale(child))));
+}
+
+// Object update component that reads a transform outside its subtree and
+// moves its own object
+class TransformReaderComponent final : public eng::Component
+{
+    COMPONENT(TransformReaderComponent)
+public:
+    void Update(float deltaTime) override
+    {
+        shared = target->GetWorldTransform();
+        GetOwner()->SetPosition(GetOwner()->GetPosition() + glm::vec3(1.0f, 0.0f, 0.0f));
+        own = GetOwner()->GetChildren()[0]->GetWorldTransform();
+    }
+
+    eng::GameObject* target = nullptr;
+    glm::mat4 shared = glm::mat4(1.0f);
+    glm::mat4 own = glm::mat4(1.0f);
+};
+
+static void ParallelUpdateReadsSharedTransforms()
+{
+    auto scene = std::make_shared<eng::Scene>();
+    scene->SetParallelUpdate(true);
+    auto camera = scene->CreateObject("Camera");
+    auto lens = scene->CreateObject("Lens", camera);
+    lens->SetPosition(glm::vec3(0.0f, 0.0f, 1.0f));
+
+    std::vector<TransformReaderComponent*> readers;
+    for (int i = 0; i < 16; ++i)
+    {
+        auto object = scene->CreateObject("Reader");
+        scene->CreateObject("Hand", object)->SetPosition(glm::vec3(0.0f, 1.0f, 0.0f));
+        auto reader = new TransformReaderComponent();
+        reader->target = lens;
+        object->AddComponent(reader);
+        readers.push_back(reader);
+    }
+
+    // Moved before the update, so every reader sees the same matrix
+    camera->SetPosition(glm::vec3(5.0f, 0.0f, 0.0f));
+    scene->Update(1.0f / 60.0f);
+    for (auto reader : readers)
+    {
+        TEST_CHECK(NearlyEqual(reader->shared, glm::translate(glm::mat4(1.0f), glm::vec3(5.0f, 0.0f, 1.0f))));
+        TEST_CHECK(NearlyEqual(reader->own, glm::translate(glm::mat4(1.0f), glm::vec3(1.0f, 1.0f, 0.0f))));
+        TEST_CHECK(NearlyEqual(reader->GetOwner()->GetChildren()[0]->GetWorldTransform(), reader->own));
+    }
+
+    // Concurrent reads of a dirty transform compute it without storing it
+    auto& store = scene->GetTransformStore();
+    store.SetPosition(camera->GetTransformId(), glm::vec3(7.0f, 0.0f, 0.0f));
+    store.MarkDirty(camera->GetTransformId());
+    store.MarkDirty(lens->GetTransformId());
+    store.SetConcurrentReads(true);
+    std::vector<std::thread> threads;
+    std::vector<glm::mat4> results(4);
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        threads.emplace_back([&store, &results, lens, i]()
+            {
+                for (int j = 0; j < 1000; ++j)
+                {
+                    results[i] = store.GetWorldTransform(lens->GetTransformId());
+                }
+            });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    store.SetConcurrentReads(false);
+    for (const auto& result : results)
+    {
+        TEST_CHECK(NearlyEqual(result, glm::translate(glm::mat4(1.0f), glm::vec3(7.0f, 0.0f, 1.0f))));
+    }
+    TEST_CHECK(!store.MarkDirty(lens->GetTransformId()));
+}
+
+void RegisterSceneTests(TestRunner& runner)
+{
+    LoggingComponent::Register();
+    ReparentComponent::Register();
+    SpawnComponent::Register();
+    TransformReaderComponent::Register();
+    runner.Add("Scene/RenameKeepsSystemComponents", RenameKeepsSystemComponents);
+    runner.Add("Scene/DestroyedObjectsAreNotFoundByName", DestroyedObjectsAreNotFoundByName);
+    runner.Add("Scene/NameLookupsFollowTreeOrder", NameLookupsFollowTreeOrder);
+    runner.Add("Scene/SystemsRunInHierarchyOrder", SystemsRunInHierarchyOrder);
+    runner.Add("Scene/InactiveSubtreesAreSkipped", InactiveSubtreesAreSkipped);
+    runner.Add("Scene/SetParentDuringUpdateIsValidated", SetParentDuringUpdateIsValidated);
+    runner.Add("Scene/SetParentDuringUpdateSeesQueuedChanges", SetParentDuringUpdateSeesQueuedChanges);
+    runner.Add("Scene/StaleHandlesDoNotResolveReusedSlots", StaleHandlesDoNotResolveReusedSlots);
+    runner.Add("Scene/MarkedObjectsDoNotResolve", MarkedObjectsDoNotResolve);
+    runner.Add("Scene/ObjectsCreatedDuringUpdateResolveAfterIt", ObjectsCreatedDuringUpdateResolveAfterIt);
+    runner.Add("Scene/WorldTransformsAreSweptIn2D", WorldTransformsAreSweptIn2D);
+    runner.Add("Scene/ParallelUpdateReadsSharedTransforms", ParallelUpdateReadsSharedTransforms);
+}
\ No newline at end of file
@@ -0,0 +1,59 @@
+#include "Test.h"
+
+#include <cstring>
+#include <iostream>
+
+size_t TestRunner::s_failedChecks = 0;
+
+void TestRunner::Add(const std::string& name, const TestFunc& func)
+{
+    m_tests.push_back({ name, func });
+}
+
+int TestRunner::Run(int argc, char** argv)
+{
+    std::string filter;
+    bool listOnly = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+        {
+            filter = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--list") == 0)
+        {
+            listOnly = true;
+        }
+    }
+
+    int failedTests = 0;
+    for (const auto& test : m_tests)
+    {
+        if (!filter.empty() && test.name.find(filter) == std::string::npos)
+        {
+            continue;
+        }
+        if (listOnly)
+        {
+            std::cout << test.name << std::endl;
+            continue;
+        }
+
+        const size_t failedBefore = s_failedChecks;
+        test.func();
+        const bool passed = s_failedChecks == failedBefore;
+        failedTests += passed ? 0 : 1;
+        std::cout << (passed ? "[ OK ] " : "[FAIL] ") << test.name << std::endl;
+    }
+
+    return failedTests;
+}
+
+void TestRunner::Check(bool condition, const char* expression, const char* file, int line)
+{
+    if (!condition)
+    {
+        ++s_failedChecks;
+        std::cerr << file << ":" << line << ": check failed: " << expression << std::endl;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+// Records a failed check and carries on with the test
+#define TEST_CHECK(condition) TestRunner::Check((condition), #condition, __FILE__, __LINE__)
+
+using TestFunc = std::function<void()>;
+
+// Runs the registered tests against a headless engine. The exit code is
+// the number of failed tests, so ctest reports them.
+class TestRunner
+{
+public:
+    void Add(const std::string& name, const TestFunc& func);
+    // Options: --filter <text>, --list
+    int Run(int argc, char** argv);
+
+    static void Check(bool condition, const char* expression, const char* file, int line);
+
+private:
+    struct Entry
+    {
+        std::string name;
+        TestFunc func;
+    };
+
+    std::vector<Entry> m_tests;
+    static size_t s_failedChecks;
+};
+
+void RegisterFrameTests(TestRunner& runner);
+void RegisterGraphicsTests(TestRunner& runner);
+void RegisterRenderTests(TestRunner& runner);
+void RegisterSceneTests(TestRunner& runner);
\ No newline at end of file
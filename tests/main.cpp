@@ -0,0 +1,49 @@
+#include "Test.h"
+#include <eng.h>
+
+// Updates whichever scene a test has set, like a game does
+class TestApp : public eng::Application
+{
+public:
+    bool Init() override;
+    void Update(float deltaTime) override;
+    void Destroy() override;
+};
+
+bool TestApp::Init()
+{
+    return true;
+}
+
+void TestApp::Update(float deltaTime)
+{
+    if (auto scene = eng::Engine::GetInstance().GetScene())
+    {
+        scene->Update(deltaTime);
+    }
+}
+
+void TestApp::Destroy()
+{
+}
+
+int main(int argc, char** argv)
+{
+    eng::Engine& engine = eng::Engine::GetInstance();
+    engine.SetApplication(new TestApp());
+    if (!engine.Init(1280, 720, true))
+    {
+        engine.Destroy();
+        return 1;
+    }
+
+    TestRunner runner;
+    RegisterFrameTests(runner);
+    RegisterGraphicsTests(runner);
+    RegisterRenderTests(runner);
+    RegisterSceneTests(runner);
+    const int result = runner.Run(argc, argv);
+
+    engine.Destroy();
+    return result;
+}
\ No newline at end of file